@@ -0,0 +1,230 @@
+/**
+ * BrainSAIT OID Scanner - JSON Serialization Benchmark
+ *
+ * Compares the streaming JsonStreamWriter against the current
+ * ArduinoJson document + String path for both payloads the firmware
+ * produces (toJSON and the sendToAPI upload body). Reports bytes per
+ * payload, bytes/sec, peak heap and peak stack per serialization.
+ *
+ * The baseline figures and the byte-identity check only mean something
+ * when built against an ArduinoJson 6 release tree (the version the
+ * firmware pins); the header line names the version in use.
+ *
+ * Usage: bench_json_stream [iterations]   (default: 200000)
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <pthread.h>
+
+#include "oid_utils.h"
+#include "scan_parser.h"
+#include "json_stream.h"
+#include "http_stream.h"
+
+// ============== Heap accounting ==============
+
+static std::atomic<size_t> heapCurrent(0);
+static std::atomic<size_t> heapPeak(0);
+
+// Size header ahead of each block; max_align_t keeps the block aligned
+union AllocHeader {
+  size_t size;
+  std::max_align_t align;
+};
+
+void* operator new(size_t size) {
+  AllocHeader* header = (AllocHeader*)malloc(sizeof(AllocHeader) + size);
+  if (!header) throw std::bad_alloc();
+  header->size = size;
+  size_t now = heapCurrent += size;
+  size_t peak = heapPeak.load();
+  while (now > peak && !heapPeak.compare_exchange_weak(peak, now)) {}
+  return (uint8_t*)header + sizeof(AllocHeader);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (!ptr) return;
+  // Step back through uintptr_t: the compiler cannot see ptr's real allocation
+  AllocHeader* header = (AllocHeader*)((uintptr_t)ptr - sizeof(AllocHeader));
+  heapCurrent -= header->size;
+  free(header);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+// ============== Stack accounting ==============
+
+static const size_t STACK_SIZE = 256 * 1024;
+static const uint8_t STACK_PAINT = 0xA5;
+
+static void* runThunk(void* arg) {
+  ((void (*)())arg)();
+  return NULL;
+}
+
+/**
+ * Run fn on a painted stack and return the bytes it touched
+ */
+static size_t stackUsed(void (*fn)()) {
+  uint8_t* stack = (uint8_t*)aligned_alloc(4096, STACK_SIZE);
+  memset(stack, STACK_PAINT, STACK_SIZE);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, STACK_SIZE);
+  pthread_t thread;
+  pthread_create(&thread, &attr, runThunk, (void*)fn);
+  pthread_join(thread, NULL);
+  pthread_attr_destroy(&attr);
+
+  size_t untouched = 0;
+  while (untouched < STACK_SIZE && stack[untouched] == STACK_PAINT) untouched++;
+  free(stack);
+  return STACK_SIZE - untouched;
+}
+
+// ============== Fixtures ==============
+
+static OID sampleOID;
+static OIDData sampleScan;
+static const String deviceIP = "192.168.100.57";
+static const char* wifiSSID = "BrainSAIT-Office";
+
+static void setupFixtures() {
+  sampleOID = parseOID("1.3.6.1.4.1.61026.3.2.1");
+  sampleOID.name = "AI Normalizer Service";
+  sampleOID.description = "Clinical coding and claim normalization service";
+  sampleOID.status = "active";
+  sampleOID.nodeType = "leaf";
+
+  sampleScan.oid = sampleOID.fullPath;
+  sampleScan.name = sampleOID.name;
+  sampleScan.valid = true;
+}
+
+static CountingPrint sink;
+
+// Current path: ArduinoJson document -> String -> output
+static void currentOID() {
+  String json = toJSON(sampleOID);
+  sink.print(json);
+}
+
+static void currentScan() {
+  StaticJsonDocument<512> doc;
+  doc["oid"] = sampleScan.oid;
+  doc["name"] = sampleScan.name;
+  doc["scannedAt"] = 123456789UL;
+  doc["deviceIP"] = deviceIP;
+  doc["wifiSSID"] = wifiSSID;
+
+  String payload;
+  serializeJson(doc, payload);
+  sink.print(payload);
+}
+
+// Streaming path: straight into the output
+static void streamOID() {
+  writeOIDJson(sink, sampleOID, true);
+}
+
+static void streamScan() {
+  ChunkedPrint body(sink);
+  writeScanJson(body, sampleScan, 123456789UL, deviceIP, wifiSSID);
+  body.finish();
+}
+
+static void streamOIDCompact() {
+  writeOIDJson(sink, sampleOID, false);
+}
+
+static void noop() {}
+
+// ============== Harness ==============
+
+struct Result {
+  size_t bytes;
+  double mbPerSec;
+  size_t heap;
+  size_t stack;
+};
+
+static Result measure(void (*fn)(), long iterations, size_t stackBaseline) {
+  Result r;
+
+  size_t before = sink.count();
+  fn();
+  r.bytes = sink.count() - before;
+
+  heapPeak = heapCurrent.load();
+  size_t heapBase = heapCurrent.load();
+  fn();
+  r.heap = heapPeak.load() - heapBase;
+
+  size_t stack = stackUsed(fn);
+  r.stack = stack > stackBaseline ? stack - stackBaseline : 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  before = sink.count();
+  for (long i = 0; i < iterations; i++) fn();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  r.mbPerSec = (sink.count() - before) / elapsed.count() / 1e6;
+  return r;
+}
+
+static void report(const char* name, const Result& r) {
+  printf("  %-34s %7zu %9.1f %9zu %9zu\n", name, r.bytes, r.mbPerSec, r.heap, r.stack);
+}
+
+#if defined(ARDUINOJSON_VERSION_MAJOR) && ARDUINOJSON_VERSION_MAJOR == 6
+#define BENCH_ARDUINOJSON_6 1
+#else
+#define BENCH_ARDUINOJSON_6 0
+#endif
+
+#ifdef ARDUINOJSON_VERSION
+#define BENCH_ARDUINOJSON_VERSION ARDUINOJSON_VERSION
+#else
+#define BENCH_ARDUINOJSON_VERSION "unknown (not a release tree)"
+#endif
+
+/**
+ * Check the streaming output is byte-identical to ArduinoJson's
+ */
+class StringPrint : public Print {
+public:
+  size_t write(uint8_t c) override { s += (char)c; return 1; }
+  using Print::write;
+  String s;
+};
+
+int main(int argc, char** argv) {
+  long iterations = argc > 1 ? atol(argv[1]) : 200000;
+  setupFixtures();
+
+  StringPrint streamed;
+  writeOIDJson(streamed, sampleOID, true);
+  bool identical = streamed.s == toJSON(sampleOID);
+
+  size_t baseline = stackUsed(noop);
+
+  printf("ArduinoJson %s\n", BENCH_ARDUINOJSON_VERSION);
+  if (!BENCH_ARDUINOJSON_6) {
+    printf("  warning: not ArduinoJson 6; baseline and identity results do not apply to the firmware\n");
+  }
+  printf("%ld iterations per case (stack baseline %zu B subtracted)\n", iterations, baseline);
+  printf("  %-34s %7s %9s %9s %9s\n", "case", "bytes", "MB/s", "heap B", "stack B");
+  report("toJSON (document + String, pretty)", measure(currentOID, iterations, baseline));
+  report("writeOIDJson (stream, pretty)", measure(streamOID, iterations, baseline));
+  report("writeOIDJson (stream, compact)", measure(streamOIDCompact, iterations, baseline));
+  report("sendToAPI body (document + String)", measure(currentScan, iterations, baseline));
+  report("writeScanJson (chunked stream)", measure(streamScan, iterations, baseline));
+  printf("  streamed pretty output identical to toJSON: %s\n", identical ? "yes" : "NO");
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * BrainSAIT OID Scanner - Logging Benchmark
+ *
+ * Measures scan-loop time for one scan's worth of log output (the lines
+ * processQRContent emits at INFO level) written three ways:
+ *   - sync:  straight to a 115200 baud UART with a 128-byte TX FIFO,
+ *            as the unconditional Serial.println calls did
+ *   - async: through the log ring, drained to the same UART by a thread
+ *   - off:   no logging (what LOG_LEVEL_NONE compiles to)
+ *
+ * Usage: bench_log [scans] [idle ms between scans]   (default: 200 50)
+ */
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "log.h"
+#include "scan_parser.h"
+#include "load_test.h"
+
+/**
+ * Emulated UART: bytes leave at the baud rate; writes block while the
+ * TX FIFO is full, as HardwareSerial does without a TX ring buffer.
+ */
+class EmulatedUart : public Print {
+public:
+  EmulatedUart(unsigned long baud, size_t fifo) : _usPerByte(10e6 / baud), _fifo(fifo) {}
+
+  size_t write(uint8_t) override { return write((const uint8_t*)"", 1); }
+
+  size_t write(const uint8_t*, size_t n) override {
+    for (size_t i = 0; i < n; i++) {
+      double now = nowUs();
+      if (_drainedAt < now) _drainedAt = now;   // Line idle
+      // Wait until there is room for one more byte in the FIFO
+      double room = _drainedAt - _fifo * _usPerByte;
+      while (nowUs() < room) {}
+      _drainedAt += _usPerByte;
+      _bytes++;
+    }
+    return n;
+  }
+  using Print::write;
+
+  size_t bytes() const { return _bytes; }
+
+private:
+  static double nowUs() {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  double _usPerByte;
+  size_t _fifo;
+  double _drainedAt = 0;
+  size_t _bytes = 0;
+};
+
+static const char* PAYLOAD =
+    "{\"oid\":\"1.3.6.1.4.1.61026.3.2.1\",\"name\":\"AI Normalizer Service\","
+    "\"description\":\"Clinical coding and claim normalization service\","
+    "\"nodeType\":\"leaf\",\"status\":\"active\"}";
+
+enum Mode { MODE_SYNC, MODE_ASYNC, MODE_OFF };
+
+static OIDData scan;
+
+// One scan: parse plus the INFO-level lines the firmware logs for it
+static void scanOnce(Mode mode, Print& uart) {
+  String content(PAYLOAD);
+  parseScanPayload(content, scan);
+
+  if (mode == MODE_SYNC) {
+    uart.println("[QR] Code detected: " + content);
+    uart.println("[OID] Valid BrainSAIT OID detected");
+    uart.printf("[Scan] %s \"%s\" type=%s status=%s\r\n", scan.oid.c_str(), scan.name.c_str(),
+                scan.nodeType.c_str(), scan.status.c_str());
+    uart.println("[API] Scan recorded successfully");
+  } else if (mode == MODE_ASYNC) {
+    LOG_I("QR", "Code detected: %s", content.c_str());
+    LOG_I("OID", "Valid BrainSAIT OID detected");
+    LOG_I("Scan", "%s \"%s\" type=%s status=%s", scan.oid.c_str(), scan.name.c_str(),
+          scan.nodeType.c_str(), scan.status.c_str());
+    LOG_I("API", "Scan recorded successfully");
+  }
+}
+
+static void run(Mode mode, const char* name, int scans, int idleMs) {
+  EmulatedUart uart(115200, 128);
+  logBegin(uart);
+
+  std::atomic<bool> stop(false);
+  std::thread drain;
+  if (mode == MODE_ASYNC) {
+    drain = std::thread([&stop]() {
+      while (!stop) {
+        logFlush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS));
+      }
+      logFlush();
+    });
+  }
+
+  uint32_t droppedBefore = logRing.dropped();
+  LatencyHistogram loop;
+  for (int i = 0; i < scans; i++) {
+    unsigned long start = micros();
+    scanOnce(mode, uart);
+    loop.record(micros() - start);
+    if (idleMs > 0) delay(idleMs);
+  }
+
+  stop = true;
+  if (drain.joinable()) drain.join();
+
+  printf("  %-6s %9lu %9lu %9lu %9lu %10zu %8lu\n", name, (unsigned long)loop.meanUs(),
+         (unsigned long)loop.percentile(50), (unsigned long)loop.percentile(99),
+         (unsigned long)loop.maxUs(), uart.bytes(),
+         (unsigned long)(logRing.dropped() - droppedBefore));
+}
+
+int main(int argc, char** argv) {
+  int scans = argc > 1 ? atoi(argv[1]) : 200;
+  int idleMs = argc > 2 ? atoi(argv[2]) : 50;
+
+  printf("%d scans, %d ms idle between scans, 115200 baud, ring %d x %d B\n", scans, idleMs,
+         LOG_RING_SLOTS, LOG_LINE_MAX);
+  printf("  %-6s %9s %9s %9s %9s %10s %8s\n", "mode", "avg us", "p50 us", "p99 us", "max us",
+         "uart bytes", "dropped");
+  run(MODE_SYNC, "sync", scans, idleMs);
+  run(MODE_ASYNC, "async", scans, idleMs);
+  run(MODE_OFF, "off", scans, idleMs);
+
+  printf("\nBurst (no idle time, ring overflows):\n");
+  run(MODE_ASYNC, "async", scans, 0);
+  return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * BrainSAIT OID Scanner - OID Set Benchmark
+ *
+ * Compares the sorted OIDSet against the firmware's string approach
+ * (a list of dotted strings, startsWith() per entry, createChildOID()
+ * per candidate arc) for lookups, subtree counts, descendant
+ * enumeration and next-free-arc.
+ *
+ * Usage: bench_oid_set [entries...]   (default: 10000 100000)
+ */
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "oid_utils.h"
+#include "oid_set.h"
+
+static const int QUERIES = 200;
+
+struct Timer {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  double nsPer(size_t ops) const {
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / (ops ? ops : 1);
+  }
+};
+
+// ============== String approach ==============
+
+static bool inSubtree(const String& oid, const String& root) {
+  return oid == root || oid.startsWith(root + ".");
+}
+
+static size_t stringCount(const std::vector<String>& oids, const String& root) {
+  size_t n = 0;
+  for (const String& oid : oids) {
+    if (oid != root && inSubtree(oid, root)) n++;
+  }
+  return n;
+}
+
+static uint64_t stringEnumerate(const std::vector<String>& oids, const String& root) {
+  uint64_t sum = 0;
+  for (const String& oid : oids) {
+    if (inSubtree(oid, root)) sum += oid.length();
+  }
+  return sum;
+}
+
+static bool stringContains(const std::vector<String>& oids, const String& oid) {
+  for (const String& s : oids) {
+    if (s == oid) return true;
+  }
+  return false;
+}
+
+static uint32_t stringNextFreeArc(const std::vector<String>& oids, const String& parent) {
+  for (uint32_t arc = 1;; arc++) {
+    String child = createChildOID(parent, (int)arc);
+    bool used = false;
+    for (const String& oid : oids) {
+      if (inSubtree(oid, child)) {
+        used = true;
+        break;
+      }
+    }
+    if (!used) return arc;
+  }
+}
+
+// ============== Data ==============
+
+static std::vector<OIDValue> generate(size_t n, std::mt19937& rng) {
+  OIDValue root;
+  parseOIDValue(BRAINSAIT_ROOT, root);
+
+  std::vector<OIDValue> out;
+  out.reserve(n);
+  while (out.size() < n) {
+    OIDValue oid = root;
+    oid.arcs[oid.depth++] = 1 + rng() % 4;         // branch
+    oid.arcs[oid.depth++] = 1 + rng() % 8;         // sub-branch
+    int extra = 1 + rng() % 4;
+    for (int i = 0; i < extra; i++) {
+      // Dense low arcs so next-free-arc has runs to skip
+      oid.arcs[oid.depth++] = 1 + rng() % (i == 0 ? 64 : 200);
+    }
+    out.push_back(oid);
+  }
+  return out;
+}
+
+static void run(size_t n) {
+  std::mt19937 rng(61026);
+  std::vector<OIDValue> values = generate(n, rng);
+
+  Timer buildSet;
+  OIDSet set;
+  set.assign(values);
+  double setBuildNs = buildSet.nsPer(set.size());
+
+  Timer buildStrings;
+  std::vector<String> strings;
+  strings.reserve(set.size());
+  for (size_t i = 0; i < set.size(); i++) strings.push_back(set.at(i).toString());
+  double stringBuildNs = buildStrings.nsPer(strings.size());
+
+  // Query roots at depth 8-10 taken from existing entries
+  std::vector<OIDValue> roots;
+  std::vector<String> rootStrings;
+  for (int i = 0; i < QUERIES; i++) {
+    OIDValue r = set.at(rng() % set.size());
+    r.depth = 8 + rng() % 3;
+    roots.push_back(r);
+    rootStrings.push_back(r.toString());
+  }
+
+  std::vector<OIDValue> probes;
+  std::vector<String> probeStrings;
+  for (int i = 0; i < QUERIES; i++) {
+    OIDValue p = (i & 1) ? set.at(rng() % set.size()) : values[rng() % values.size()];
+    if (i % 4 == 3) p.arcs[p.depth - 1] += 1000;   // some misses
+    probes.push_back(p);
+    probeStrings.push_back(p.toString());
+  }
+
+  size_t mismatches = 0;
+  volatile uint64_t sink = 0;
+
+  // contains
+  Timer t1;
+  for (const OIDValue& p : probes) sink += set.contains(p);
+  double setContains = t1.nsPer(QUERIES);
+  Timer t2;
+  for (const String& p : probeStrings) sink += stringContains(strings, p);
+  double strContains = t2.nsPer(QUERIES);
+
+  // count descendants
+  std::vector<size_t> setCounts, strCounts;
+  Timer t3;
+  for (const OIDValue& r : roots) setCounts.push_back(set.countDescendants(r));
+  double setCount = t3.nsPer(QUERIES);
+  Timer t4;
+  for (const String& r : rootStrings) strCounts.push_back(stringCount(strings, r));
+  double strCount = t4.nsPer(QUERIES);
+  for (int i = 0; i < QUERIES; i++) mismatches += setCounts[i] != strCounts[i];
+
+  // enumerate descendants (format each one, as a listing would)
+  uint64_t setChars = 0, strChars = 0;
+  Timer t5;
+  for (const OIDValue& r : roots) {
+    OIDRange range = set.subtree(r);
+    char buf[OID_MAX_ARCS * 11];
+    for (size_t i = range.first; i < range.last; i++) setChars += set.at(i).toChars(buf, sizeof(buf));
+  }
+  double setEnum = t5.nsPer(QUERIES);
+  Timer t6;
+  for (const String& r : rootStrings) strChars += stringEnumerate(strings, r);
+  double strEnum = t6.nsPer(QUERIES);
+  mismatches += setChars != strChars;
+
+  // next free arc
+  std::vector<uint32_t> setArcs, strArcs;
+  Timer t7;
+  for (const OIDValue& r : roots) {
+    uint32_t arc = 0;
+    set.nextFreeArc(r, arc);
+    setArcs.push_back(arc);
+  }
+  double setNext = t7.nsPer(QUERIES);
+  Timer t8;
+  for (const String& r : rootStrings) strArcs.push_back(stringNextFreeArc(strings, r));
+  double strNext = t8.nsPer(QUERIES);
+  for (int i = 0; i < QUERIES; i++) mismatches += setArcs[i] != strArcs[i];
+
+  size_t stringBytes = 0;
+  for (const String& s : strings) stringBytes += sizeof(String) + s.length() + 1;
+
+  printf("\n%zu entries (%zu unique), %d queries each\n", n, set.size(), QUERIES);
+  printf("  %-22s %14s %14s %9s\n", "operation", "OIDSet ns/op", "String ns/op", "speedup");
+  printf("  %-22s %14.0f %14.0f %8.1fx\n", "build (per entry)", setBuildNs, stringBuildNs,
+         stringBuildNs / setBuildNs);
+  printf("  %-22s %14.0f %14.0f %8.1fx\n", "contains", setContains, strContains, strContains / setContains);
+  printf("  %-22s %14.0f %14.0f %8.1fx\n", "count descendants", setCount, strCount, strCount / setCount);
+  printf("  %-22s %14.0f %14.0f %8.1fx\n", "enumerate descendants", setEnum, strEnum, strEnum / setEnum);
+  printf("  %-22s %14.0f %14.0f %8.1fx\n", "next free arc", setNext, strNext, strNext / setNext);
+  printf("  memory: OIDSet %zu B/entry (OIDValue %zu B), String list ~%zu B/entry (plus heap overhead)\n",
+         set.memoryUsed() / set.size(), sizeof(OIDValue), stringBytes / strings.size());
+  printf("  result mismatches: %zu\n", mismatches);
+  (void)sink;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    run(10000);
+    run(100000);
+    return 0;
+  }
+  for (int i = 1; i < argc; i++) run(strtoul(argv[i], NULL, 10));
+  return 0;
+}
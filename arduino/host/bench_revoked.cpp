@@ -0,0 +1,144 @@
+/**
+ * BrainSAIT OID Scanner - Revoked Filter Benchmark
+ *
+ * Builds the revoked-OID Bloom filter at several bits per entry, sized
+ * the way ingest_server sizes it (revokedFilterCapacity), and measures
+ * insert and lookup cost (hits and misses separately), the measured
+ * false-positive rate over OIDs that were never revoked against the
+ * expected rate, and memory, next to an exact OIDSet of the same
+ * entries (what the device would need to hold the list itself).
+ *
+ * Usage: bench_revoked [revoked] [non-member probes]   (default: 100000 1000000)
+ */
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "oid_utils.h"
+#include "oid_set.h"
+#include "revoked_filter.h"
+
+static const float BITS_PER_ENTRY[] = { 8, 10, 12, 16 };
+
+struct Timer {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  double nsPer(size_t ops) const {
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / (ops ? ops : 1);
+  }
+};
+
+// Print that only counts bytes (snapshot size check)
+class CountingPrint : public Print {
+public:
+  size_t write(uint8_t) override { _bytes++; return 1; }
+  size_t write(const uint8_t*, size_t n) override { _bytes += n; return n; }
+  using Print::write;
+  size_t bytes() const { return _bytes; }
+
+private:
+  size_t _bytes = 0;
+};
+
+// ============== Data ==============
+
+static OIDValue randomOID(std::mt19937& rng, uint32_t branch) {
+  OIDValue oid;
+  parseOIDValue(BRAINSAIT_ROOT, oid);
+  oid.arcs[oid.depth++] = branch;
+  oid.arcs[oid.depth++] = 1 + rng() % 8;
+  int extra = 1 + rng() % 4;
+  for (int i = 0; i < extra; i++) oid.arcs[oid.depth++] = 1 + rng() % 5000;
+  return oid;
+}
+
+/**
+ * Revoked OIDs live under branches 1-4; probes are drawn the same way
+ * and rejected if revoked, so they share prefixes with real entries.
+ */
+static void generate(size_t revokedCount, size_t probeCount, OIDSet& revoked,
+                     std::vector<OIDValue>& members, std::vector<OIDValue>& probes) {
+  std::mt19937 rng(61026);
+  while (revoked.size() < revokedCount) revoked.insert(randomOID(rng, 1 + rng() % 4));
+  members.clear();
+  for (size_t i = 0; i < revoked.size(); i++) members.push_back(revoked.at(i));
+  std::shuffle(members.begin(), members.end(), rng);
+
+  probes.clear();
+  probes.reserve(probeCount);
+  while (probes.size() < probeCount) {
+    OIDValue oid = randomOID(rng, 1 + rng() % 4);
+    if (!revoked.contains(oid)) probes.push_back(oid);
+  }
+}
+
+// ============== Benchmark ==============
+
+static void run(float bitsPerEntry, const std::vector<OIDValue>& members,
+                const std::vector<OIDValue>& probes) {
+  RevokedFilter filter;
+  uint32_t capacity = revokedFilterCapacity(members.size(), bitsPerEntry);
+  if (capacity == 0 || !filter.createFor(capacity, bitsPerEntry)) {
+    printf("  %5.0f  filter too large (max %lu bytes)\n", bitsPerEntry,
+           (unsigned long)REVOKED_FILTER_MAX_BYTES);
+    return;
+  }
+
+  Timer insert;
+  for (const OIDValue& oid : members) filter.add(oid);
+  double insertNs = insert.nsPer(members.size());
+
+  size_t missedMembers = 0;
+  Timer hits;
+  for (const OIDValue& oid : members) missedMembers += !filter.mayContain(oid);
+  double hitNs = hits.nsPer(members.size());
+
+  size_t falsePositives = 0;
+  Timer misses;
+  for (const OIDValue& oid : probes) falsePositives += filter.mayContain(oid);
+  double missNs = misses.nsPer(probes.size());
+
+  CountingPrint snapshot;
+  filter.save(snapshot);
+
+  double measured = (double)falsePositives / probes.size();
+  double expected = filter.falsePositiveRate();
+
+  // A scan costs one lookup, plus an upstream check on a filter hit
+  printf("  %5.0f %3u %9zu %9.0f %8.1f %8.1f %9.3f%% %9.3f%% %11.0f\n", bitsPerEntry,
+         (unsigned)filter.hashCount(), snapshot.bytes(), insertNs, hitNs, missNs,
+         measured * 100, expected * 100, measured * 1e6);
+  if (missedMembers) printf("  !! %zu revoked OIDs not found\n", missedMembers);
+}
+
+int main(int argc, char** argv) {
+  size_t revokedCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+  size_t probeCount = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+
+  OIDSet exact;
+  std::vector<OIDValue> members, probes;
+  generate(revokedCount, probeCount, exact, members, probes);
+
+  volatile size_t sink = 0;
+  Timer exactHits;
+  for (const OIDValue& oid : members) sink += exact.contains(oid);
+  double exactHitNs = exactHits.nsPer(members.size());
+  Timer exactMisses;
+  for (const OIDValue& oid : probes) sink += exact.contains(oid);
+  double exactMissNs = exactMisses.nsPer(probes.size());
+  (void)sink;
+
+  printf("%zu revoked OIDs, %zu non-member probes\n\n", members.size(), probes.size());
+  printf("  %5s %3s %9s %9s %8s %8s %10s %10s %11s\n", "bits", "k", "bytes", "add ns",
+         "hit ns", "miss ns", "FPR", "expected", "checks/1M");
+  for (float bits : BITS_PER_ENTRY) run(bits, members, probes);
+
+  printf("\nExact OIDSet (binary search): %zu bytes, hit %.1f ns, miss %.1f ns\n",
+         exact.memoryUsed(), exactHitNs, exactMissNs);
+  printf("checks/1M: upstream confirmations per million non-revoked scans\n");
+  return 0;
+}
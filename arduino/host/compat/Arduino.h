@@ -0,0 +1,256 @@
+/**
+ * BrainSAIT OID Scanner - Host Arduino Compatibility Layer
+ *
+ * Minimal stand-ins for the Arduino core types (String, Print, Stream,
+ * Serial, timing) so the firmware's portable headers build natively on
+ * Linux for load tests, benchmarks and bench tooling.
+ *
+ * Only the subset of the Arduino API used by the firmware is provided.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+
+#define HOST_BUILD 1
+
+// ============== Timing ==============
+
+inline uint64_t hostMonotonicMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+inline uint64_t hostStartMicros() {
+  static const uint64_t start = hostMonotonicMicros();
+  return start;
+}
+
+inline unsigned long micros() {
+  uint64_t start = hostStartMicros();   // Initialize before reading the clock
+  return (unsigned long)(hostMonotonicMicros() - start);
+}
+
+inline unsigned long millis() {
+  return micros() / 1000UL;
+}
+
+inline void delay(unsigned long ms) {
+  usleep(ms * 1000UL);
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  usleep(us);
+}
+
+inline void yield() {}
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+// ============== String ==============
+
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const char* s, size_t n) : _s(s, n) {}
+  String(const std::string& s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(int v) : _s(std::to_string(v)) {}
+  explicit String(unsigned int v) : _s(std::to_string(v)) {}
+  explicit String(long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long v) : _s(std::to_string(v)) {}
+  explicit String(long long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long long v) : _s(std::to_string(v)) {}
+
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  const char* c_str() const { return _s.c_str(); }
+  void reserve(unsigned int n) { _s.reserve(n); }
+
+  char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : '\0'; }
+  char& operator[](unsigned int i) { return _s[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  bool concat(const char* s) { if (s) _s += s; return true; }
+  bool concat(const char* s, unsigned int n) { _s.append(s, n); return true; }
+  bool concat(const String& s) { _s += s._s; return true; }
+  bool concat(char c) { _s += c; return true; }
+
+  String& operator+=(const String& s) { _s += s._s; return *this; }
+  String& operator+=(const char* s) { if (s) _s += s; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(int v) { _s += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { _s += std::to_string(v); return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+  friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+  friend String operator+(const String& a, char c) { return String(a._s + c); }
+
+  bool operator==(const String& o) const { return _s == o._s; }
+  bool operator==(const char* o) const { return _s == (o ? o : ""); }
+  bool operator!=(const String& o) const { return _s != o._s; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return _s < o._s; }
+  bool equals(const String& o) const { return _s == o._s; }
+
+  bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+  bool startsWith(const char* p) const { return startsWith(String(p)); }
+  bool endsWith(const String& p) const {
+    return _s.size() >= p._s.size() &&
+           _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return npos(_s.find(c, from)); }
+  int indexOf(const String& s, unsigned int from = 0) const { return npos(_s.find(s._s, from)); }
+  int lastIndexOf(char c) const { return npos(_s.rfind(c)); }
+  int lastIndexOf(const String& s) const { return npos(_s.rfind(s._s)); }
+
+  String substring(unsigned int from) const {
+    return from >= _s.size() ? String() : String(_s.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (from >= _s.size()) return String();
+    return String(_s.substr(from, to - from));
+  }
+
+  long toInt() const { return strtol(_s.c_str(), NULL, 10); }
+
+  void trim() {
+    size_t b = 0, e = _s.size();
+    while (b < e && isspace((unsigned char)_s[b])) b++;
+    while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+    _s = _s.substr(b, e - b);
+  }
+  void toLowerCase() { for (char& c : _s) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : _s) c = (char)toupper((unsigned char)c); }
+
+private:
+  static int npos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  std::string _s;
+};
+
+// ============== Print / Stream ==============
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& out) const = 0;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t written = 0;
+    while (n--) written += write(*buf++);
+    return written;
+  }
+  virtual void flush() {}
+
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+  size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+  size_t print(const Printable& p) { return p.printTo(*this); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& v) { return print(v) + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(buf)) return write(buf, (size_t)n);
+
+    std::string big((size_t)n + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&big[0], big.size(), fmt, args);
+    va_end(args);
+    return write(big.data(), (size_t)n);
+  }
+};
+
+class Stream : public Print {
+public:
+  using Print::write;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * Serial stand-in: writes to stdout, reads stdin without blocking.
+ */
+class HostSerial : public Stream {
+public:
+  using Print::write;
+
+  void begin(unsigned long) {
+    int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+    if (flags >= 0) fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+  }
+
+  size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+  size_t write(const uint8_t* buf, size_t n) override { return fwrite(buf, 1, n, stdout); }
+  void flush() override { fflush(stdout); }
+
+  int available() override {
+    fill();
+    return _len - _pos;
+  }
+  int read() override {
+    fill();
+    return _pos < _len ? (unsigned char)_buf[_pos++] : -1;
+  }
+  int peek() override {
+    fill();
+    return _pos < _len ? (unsigned char)_buf[_pos] : -1;
+  }
+
+private:
+  void fill() {
+    if (_pos < _len) return;
+    ssize_t n = ::read(STDIN_FILENO, _buf, sizeof(_buf));
+    _pos = 0;
+    _len = n > 0 ? (int)n : 0;
+  }
+
+  char _buf[256];
+  int _pos = 0;
+  int _len = 0;
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,2 @@
+// Forwarding header for libraries that include the Arduino core piecemeal.
+#include "Arduino.h"
@@ -0,0 +1,19 @@
+/**
+ * BrainSAIT OID Scanner - EEPROM Declarations (sketch check only)
+ */
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include "esp32_core.h"
+
+class EEPROMClass {
+public:
+  bool begin(size_t size);
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  bool commit();
+};
+extern EEPROMClass EEPROM;
+
+#endif // HOST_EEPROM_H
@@ -0,0 +1,30 @@
+/**
+ * BrainSAIT OID Scanner - LittleFS Declarations (sketch check only)
+ */
+
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include "esp32_core.h"
+
+class File : public Stream {
+public:
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  size_t read(uint8_t* buf, size_t n);
+  int peek() override;
+  void close();
+  operator bool() const;
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool formatOnFail = false);
+  File open(const char* path, const char* mode = "r");
+};
+extern LittleFSFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,43 @@
+/**
+ * BrainSAIT OID Scanner - WiFi Declarations (sketch check only)
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "esp32_core.h"
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class IPAddress : public Printable {
+public:
+  String toString() const;
+  size_t printTo(Print& out) const override;
+};
+
+class WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* password);
+  wl_status_t status();
+  IPAddress localIP();
+  int8_t RSSI();
+};
+extern WiFiClass WiFi;
+
+class WiFiClient : public Stream {
+public:
+  virtual ~WiFiClient();
+  virtual int connect(const char* host, uint16_t port);
+  virtual int connect(const char* host, uint16_t port, int32_t timeoutMs);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  virtual int read(uint8_t* buf, size_t n);
+  int peek() override;
+  virtual uint8_t connected();
+  virtual void stop();
+};
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,17 @@
+/**
+ * BrainSAIT OID Scanner - TLS Client Declarations (sketch check only)
+ */
+
+#ifndef HOST_WIFI_CLIENT_SECURE_H
+#define HOST_WIFI_CLIENT_SECURE_H
+
+#include "WiFi.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  WiFiClientSecure();
+  void setInsecure();
+  void setHandshakeTimeout(unsigned long timeoutSeconds);
+};
+
+#endif // HOST_WIFI_CLIENT_SECURE_H
@@ -0,0 +1,69 @@
+/**
+ * BrainSAIT OID Scanner - ESP32 Core Declarations (sketch check only)
+ *
+ * Declarations of the ESP32 Arduino core, FreeRTOS and driver APIs the
+ * sketch calls, so `make sketch-check` can type-check oid-qr-scanner.ino
+ * on a host. Nothing here is defined: the check compiles with
+ * -fsyntax-only and never links. Build for the board with `pio run`.
+ */
+
+#ifndef HOST_ESP32_CORE_H
+#define HOST_ESP32_CORE_H
+
+#include <Arduino.h>
+
+// ============== GPIO ==============
+
+#define LOW     0
+#define HIGH    1
+#define OUTPUT  0x03
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long durationMs = 0);
+
+// ============== UART ==============
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial : public Stream {
+public:
+  explicit HardwareSerial(int uart);
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1,
+             int8_t txPin = -1);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+};
+
+// ============== System ==============
+
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+};
+extern EspClass ESP;
+
+// ============== FreeRTOS ==============
+
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* params, unsigned priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+#endif // HOST_ESP32_CORE_H
@@ -0,0 +1,462 @@
+/**
+ * BrainSAIT OID Scanner - Ingest Load Generator
+ *
+ * Simulates a fleet of scanners uploading to ingest_server (or any
+ * /oid/scan endpoint). Every upload goes out the way sendToAPI sends it:
+ * a fresh connection, the firmware's headers, a chunked body from
+ * writeScanJson and the response read by readHttpResponse.
+ *
+ * Each scanner is a thread uploading at Poisson-spaced times with a
+ * realistic mix:
+ *   - Label popularity is skewed; a few hot assets get most scans
+ *   - 8% of scans repeat the scanner's previous label
+ *   - 2% carry an OID outside the BrainSAIT arc (the server rejects them)
+ *   - Some uploads (default 5%) are offline backlog flushes of 5-50 scans
+ *
+ * Latency is measured from each upload's scheduled time, so a slow
+ * server shows up as queueing delay rather than as a lower request rate.
+ *
+ * Usage: ingest_loadgen [-h host] [-p port] [-n scanners] [-d seconds]
+ *                       [-r uploads/min per scanner] [-b batch %] [-k api key] [-s seed]
+ */
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "oid_utils.h"
+#include "scan_parser.h"
+#include "json_stream.h"
+#include "http_stream.h"
+#include "load_test.h"
+
+#define LOADGEN_LABELS         2048    // Distinct labels in the catalog
+#define LOADGEN_REPEAT_PCT     8       // Scans that repeat the previous label
+#define LOADGEN_FOREIGN_PCT    2       // Scans with a non-BrainSAIT OID
+#define LOADGEN_BATCH_MIN      5
+#define LOADGEN_BATCH_MAX      50
+#define LOADGEN_POLL_MS        10      // available() wait before reporting 0
+
+static std::atomic<bool> running(true);
+static std::atomic<uint64_t> completed(0);
+
+/**
+ * Blocking TCP client with the WiFiClient subset the firmware uses
+ *
+ * Writes are collected and sent by transmit(), so a request leaves in as
+ * few segments as the device's socket buffer would produce. available()
+ * waits up to LOADGEN_POLL_MS for data, which keeps readHttpResponse's
+ * 1 ms idle delay out of the measured latency.
+ */
+class HostClient : public Print {
+public:
+  ~HostClient() { stop(); }
+
+  bool connect(const sockaddr_in& addr) {
+    _fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_fd < 0) return false;
+    if (::connect(_fd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+      stop();
+      return false;
+    }
+    int one = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    _connected = true;
+    _pos = _len = 0;
+    _out.clear();
+    return true;
+  }
+
+  size_t write(uint8_t c) override { _out += (char)c; return 1; }
+  size_t write(const uint8_t* data, size_t n) override {
+    _out.append((const char*)data, n);
+    return n;
+  }
+  using Print::write;
+
+  bool transmit() {
+    size_t sent = 0;
+    while (sent < _out.size()) {
+      ssize_t n = send(_fd, _out.data() + sent, _out.size() - sent, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        _connected = false;
+        return false;
+      }
+      sent += n;
+    }
+    _out.clear();
+    return true;
+  }
+
+  int available() {
+    if (_pos < _len) return _len - _pos;
+    if (!_connected) return 0;
+
+    pollfd p = { _fd, POLLIN, 0 };
+    if (poll(&p, 1, LOADGEN_POLL_MS) <= 0) return 0;
+    ssize_t n = recv(_fd, _in, sizeof(_in), 0);
+    if (n <= 0) {
+      _connected = false;
+      return 0;
+    }
+    _pos = 0;
+    _len = n;
+    return _len;
+  }
+
+  int read() {
+    if (_pos >= _len && available() == 0) return -1;
+    return (uint8_t)_in[_pos++];
+  }
+
+  bool connected() const { return _connected || _pos < _len; }
+
+  void stop() {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+    _connected = false;
+  }
+
+private:
+  int _fd = -1;
+  bool _connected = false;
+  std::string _out;
+  char _in[1024];
+  int _pos = 0;
+  int _len = 0;
+};
+
+// ============== Scanner simulation ==============
+
+struct LoadConfig {
+  sockaddr_in addr;
+  HttpEndpoint single;
+  HttpEndpoint batch;
+  const char* apiKey;
+  unsigned scanners;
+  unsigned seconds;
+  double uploadsPerMinute;
+  unsigned batchPct;
+  uint32_t seed;
+};
+
+struct ScannerResult {
+  LatencyHistogram singleLatency;
+  LatencyHistogram batchLatency;
+  uint64_t uploads = 0;
+  uint64_t batches = 0;
+  uint64_t scans = 0;
+  uint64_t foreignScans = 0;
+  uint64_t status2xx = 0;
+  uint64_t status4xx = 0;
+  uint64_t status5xx = 0;
+  uint64_t failed = 0;       // Connect, send or read errors
+};
+
+class Scanner {
+public:
+  Scanner(unsigned id, const LoadConfig& config) : _id(id), _config(config) {
+    _rng = config.seed ^ (0x9E3779B9u * (id + 1));
+    if (_rng == 0) _rng = 1;
+    char buf[32];
+    snprintf(buf, sizeof(buf), "OID-Scanner-%03u", id + 1);
+    _device = buf;
+    snprintf(buf, sizeof(buf), "10.61.%u.%u", 1 + id / 250, 1 + id % 250);
+    _deviceIP = buf;
+  }
+
+  void run() {
+    double meanGapUs = 60e6 / _config.uploadsPerMinute;
+    uint64_t start = hostMonotonicMicros();
+    uint64_t end = start + (uint64_t)_config.seconds * 1000000ULL;
+    uint64_t next = start + (uint64_t)exponential(meanGapUs);
+
+    while (running && next < end) {
+      uint64_t now = hostMonotonicMicros();
+      if (next > now) {
+        usleep(next - now);
+        continue;   // Re-check running after the sleep
+      }
+
+      bool batch = _config.batchPct > 0 && nextRandom() % 100 < _config.batchPct;
+      int status = batch ? uploadBatch() : uploadSingle();
+      uint32_t latency = (uint32_t)(hostMonotonicMicros() - next);
+
+      (batch ? result.batchLatency : result.singleLatency).record(latency);
+      result.uploads++;
+      if (status < 0) result.failed++;
+      else if (status < 300) result.status2xx++;
+      else if (status < 500) result.status4xx++;
+      else result.status5xx++;
+      completed++;
+
+      next += (uint64_t)exponential(meanGapUs);
+    }
+  }
+
+  ScannerResult result;
+
+private:
+  uint32_t nextRandom() {
+    // xorshift32, as in LoadTest
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+  }
+
+  double exponential(double mean) {
+    double u = (nextRandom() + 1.0) / 4294967297.0;
+    return -log(u) * mean;
+  }
+
+  // Next label this scanner reads; returns false for a foreign OID
+  bool nextScan(OIDData& scan) {
+    if (_lastLabel >= 0 && nextRandom() % 100 < LOADGEN_REPEAT_PCT) {
+      fillLabel(scan, _lastLabel);
+      return true;
+    }
+
+    if (nextRandom() % 100 < LOADGEN_FOREIGN_PCT) {
+      char oid[48];
+      snprintf(oid, sizeof(oid), "1.3.6.1.4.1.9999.%u", 1 + nextRandom() % 64);
+      scan.oid = oid;
+      scan.name = "Foreign Label";
+      scan.valid = true;
+      return false;
+    }
+
+    // Squaring a uniform draw puts most scans on the lowest indices
+    uint32_t r = nextRandom() % LOADGEN_LABELS;
+    _lastLabel = (int)((uint64_t)r * r / LOADGEN_LABELS);
+    fillLabel(scan, _lastLabel);
+    return true;
+  }
+
+  static void fillLabel(OIDData& scan, int label) {
+    char oid[48];
+    char name[32];
+    snprintf(oid, sizeof(oid), BRAINSAIT_ROOT ".%d.%d.%d", 1 + label % 4, 1 + (label / 4) % 8,
+             1 + label / 32);
+    snprintf(name, sizeof(name), "Asset %d", label);
+    scan.oid = oid;
+    scan.name = name;
+    scan.valid = true;
+  }
+
+  bool beginUpload(const HttpEndpoint& endpoint, const String& oidHeader) {
+    if (!_client.connect(_config.addr)) return false;
+
+    HttpHeadBuffer head(_client);
+    beginChunkedRequest(head, "POST", endpoint, "application/json");
+    if (_config.apiKey) writeHttpHeader(head, "X-BrainSAIT-API-Key", _config.apiKey);
+    writeHttpHeader(head, "X-BrainSAIT-Device", _device);
+    if (oidHeader.length()) writeHttpHeader(head, "X-BrainSAIT-OID", oidHeader);
+    writeHttpHeader(head, "X-BrainSAIT-PEN", "61026");
+    endHttpHeaders(head);
+    head.send();
+    return true;
+  }
+
+  int finishUpload() {
+    int status = HTTP_STREAM_ERROR_CLOSED;
+    if (_client.transmit()) {
+      String response;
+      status = readHttpResponse(_client, response, 0);
+    }
+    _client.stop();
+    return status;
+  }
+
+  int uploadSingle() {
+    OIDData scan;
+    bool brainsait = nextScan(scan);
+    result.scans++;
+    if (!brainsait) result.foreignScans++;
+
+    if (!beginUpload(_config.single, scan.oid)) return HTTP_STREAM_ERROR_CLOSED;
+    ChunkedPrint body(_client);
+    writeScanJson(body, scan, millis(), _deviceIP, "BrainSAIT-Office");
+    body.finish();
+
+    return finishUpload();
+  }
+
+  int uploadBatch() {
+    unsigned count = LOADGEN_BATCH_MIN + nextRandom() % (LOADGEN_BATCH_MAX - LOADGEN_BATCH_MIN + 1);
+    result.batches++;
+
+    if (!beginUpload(_config.batch, String())) return HTTP_STREAM_ERROR_CLOSED;
+    ChunkedPrint body(_client);
+    body.write('[');
+    // Backlogged scans were taken over the time the scanner was offline
+    unsigned long scannedAt = millis() - count * 30000UL;
+    for (unsigned i = 0; i < count; i++) {
+      OIDData scan;
+      if (!nextScan(scan)) result.foreignScans++;
+      if (i > 0) body.write(',');
+      writeScanJson(body, scan, scannedAt + i * 30000UL, _deviceIP, "BrainSAIT-Office");
+    }
+    body.write(']');
+    body.finish();
+    result.scans += count;
+
+    return finishUpload();
+  }
+
+  unsigned _id;
+  const LoadConfig& _config;
+  uint32_t _rng;
+  int _lastLabel = -1;
+  String _device;
+  String _deviceIP;
+  HostClient _client;
+};
+
+// ============== Main ==============
+
+static void printLatency(const char* label, const LatencyHistogram& h) {
+  printf("%s n=%lu min=%lu avg=%lu p50=%lu p90=%lu p99=%lu p99.9=%lu max=%lu\n", label,
+         (unsigned long)h.count(), (unsigned long)h.minUs(), (unsigned long)h.meanUs(),
+         (unsigned long)h.percentile(50), (unsigned long)h.percentile(90),
+         (unsigned long)h.percentile(99), (unsigned long)h.percentile(99.9f),
+         (unsigned long)h.maxUs());
+}
+
+static void onSignal(int) {
+  running = false;
+}
+
+static void usage(const char* name) {
+  fprintf(stderr,
+          "Usage: %s [-h host] [-p port] [-n scanners] [-d seconds] [-r uploads/min per scanner]\n"
+          "          [-b batch %%] [-k api key] [-s seed]\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  const char* host = "127.0.0.1";
+  uint16_t port = 8080;
+  LoadConfig config;
+  config.apiKey = NULL;
+  config.scanners = 200;
+  config.seconds = 30;
+  config.uploadsPerMinute = 30;
+  config.batchPct = 5;
+  config.seed = 61026;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "h:p:n:d:r:b:k:s:")) != -1) {
+    switch (opt) {
+      case 'h': host = optarg; break;
+      case 'p': port = (uint16_t)atoi(optarg); break;
+      case 'n': config.scanners = (unsigned)atoi(optarg); break;
+      case 'd': config.seconds = (unsigned)atoi(optarg); break;
+      case 'r': config.uploadsPerMinute = atof(optarg); break;
+      case 'b': config.batchPct = (unsigned)atoi(optarg); break;
+      case 'k': config.apiKey = optarg; break;
+      case 's': config.seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (config.scanners == 0 || config.seconds == 0 || config.uploadsPerMinute <= 0 ||
+      config.batchPct > 100) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* resolved;
+  if (getaddrinfo(host, NULL, &hints, &resolved) != 0) {
+    fprintf(stderr, "[LoadGen] Cannot resolve %s\n", host);
+    return 1;
+  }
+  config.addr = *(sockaddr_in*)resolved->ai_addr;
+  config.addr.sin_port = htons(port);
+  freeaddrinfo(resolved);
+
+  char base[128];
+  snprintf(base, sizeof(base), "http://%s:%u/oid", host, port);
+  parseHttpUrl(String(base) + "/scan", config.single);
+  parseHttpUrl(String(base) + "/scan/batch", config.batch);
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, onSignal);
+
+  printf("[LoadGen] %u scanners -> %s, %u s, %.1f uploads/min each, %u%% batches\n",
+         config.scanners, base, config.seconds, config.uploadsPerMinute, config.batchPct);
+  fflush(stdout);
+
+  std::vector<Scanner*> scanners;
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < config.scanners; i++) scanners.push_back(new Scanner(i, config));
+  uint64_t start = hostMonotonicMicros();
+  for (Scanner* s : scanners) threads.emplace_back(&Scanner::run, s);
+
+  // Progress once a second
+  uint64_t lastCompleted = 0;
+  uint64_t end = start + (uint64_t)config.seconds * 1000000ULL;
+  while (running && hostMonotonicMicros() < end) {
+    delay(1000);
+    uint64_t done = completed.load();
+    printf("[LoadGen] %llu uploads/s\n", (unsigned long long)(done - lastCompleted));
+    fflush(stdout);
+    lastCompleted = done;
+  }
+
+  for (std::thread& t : threads) t.join();
+  double seconds = (hostMonotonicMicros() - start) / 1e6;
+
+  ScannerResult total;
+  for (Scanner* s : scanners) {
+    const ScannerResult& r = s->result;
+    total.singleLatency.merge(r.singleLatency);
+    total.batchLatency.merge(r.batchLatency);
+    total.uploads += r.uploads;
+    total.batches += r.batches;
+    total.scans += r.scans;
+    total.foreignScans += r.foreignScans;
+    total.status2xx += r.status2xx;
+    total.status4xx += r.status4xx;
+    total.status5xx += r.status5xx;
+    total.failed += r.failed;
+    delete s;
+  }
+
+  LatencyHistogram all;
+  all.merge(total.singleLatency);
+  all.merge(total.batchLatency);
+
+  printf("\n[LoadGen] Uploads: %llu in %.1f s (%.1f req/s), %llu batches\n",
+         (unsigned long long)total.uploads, seconds, total.uploads / seconds,
+         (unsigned long long)total.batches);
+  printf("[LoadGen] Scans: %llu (%.1f scans/s), %llu foreign OIDs\n",
+         (unsigned long long)total.scans, total.scans / seconds,
+         (unsigned long long)total.foreignScans);
+  printf("[LoadGen] Responses: 2xx=%llu 4xx=%llu 5xx=%llu failed=%llu\n",
+         (unsigned long long)total.status2xx, (unsigned long long)total.status4xx,
+         (unsigned long long)total.status5xx, (unsigned long long)total.failed);
+  printLatency("[LoadGen] Latency (us), all:   ", all);
+  printLatency("[LoadGen] Latency (us), single:", total.singleLatency);
+  printLatency("[LoadGen] Latency (us), batch: ", total.batchLatency);
+
+  bool clean = total.status5xx == 0 && total.failed == 0 && total.status4xx == 0;
+  return clean ? 0 : 1;
+}
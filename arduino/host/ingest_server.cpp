@@ -0,0 +1,1190 @@
+/**
+ * BrainSAIT OID Scanner - Scan Ingest Server
+ *
+ * Native stand-in for the NetworkShare server the scanners upload to
+ * (config.h: http://<host>:8080/oid), so the device upload path can be
+ * exercised and load-tested on one machine.
+ *
+ *   POST /oid/scan        One scan object, or an array of them
+ *   POST /oid/scan/batch  Array of scan objects
+ *   GET  /oid/stats       Counters as JSON
+ *
+ *   GET  /oid/revoked/filter               Bloom filter snapshot (revoked_filter.h)
+ *   GET  /oid/revoked/delta?generation=G&since=V
+ *   GET  /oid/revoked/<oid>                200 revoked, 404 not revoked
+ *   POST /oid/revoked                      Revoke a JSON array of OIDs
+ *
+ * Each worker thread runs its own epoll loop on an SO_REUSEPORT listener.
+ * Request bodies may use Content-Length or chunked transfer encoding (the
+ * firmware streams chunked). Accepted scans are appended to the log as
+ * one JSON line each; every loop round writes its lines with a single
+ * append before any of that round's responses are sent.
+ *
+ * Revocations are kept in a text file, one OID per line, appended to by
+ * POST /oid/revoked. A revocation's version is its line number. The
+ * filter's capacity and generation are saved next to it (<file>.meta), so
+ * a restart rebuilds the same filter and devices' deltas stay valid. If
+ * lines were removed (Bloom filters cannot delete), the restart starts a
+ * new generation and devices fetch a fresh snapshot.
+ *
+ * Usage: ingest_server [-p port] [-t threads] [-l log file] [-k api key]
+ *                      [-i stats interval s] [-f (fdatasync each round)]
+ *                      [-r revoked file] [-b filter bits per entry] [-g new generation]
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "oid_utils.h"
+#include "json_stream.h"
+#include "load_test.h"
+#include "oid_set.h"
+#include "revoked_filter.h"
+
+#define INGEST_DEFAULT_PORT   8080
+#define INGEST_MAX_HEADER     8192          // Request line + headers
+#define INGEST_MAX_BODY       (1 << 20)     // Largest accepted batch
+#define INGEST_MAX_EVENTS     256           // epoll events per round
+#define INGEST_READ_CHUNK     16384
+
+// ============== Shared state ==============
+
+static std::atomic<bool> running(true);
+static std::atomic<uint64_t> nextSeq(1);
+
+static int logFd = -1;
+static bool syncLog = false;
+static const char* apiKey = NULL;
+static OIDValue brainsaitRoot;
+static uint64_t startedUs;
+
+static std::atomic<uint64_t> totalRequests(0);
+static std::atomic<uint64_t> scansAccepted(0);
+static std::atomic<uint64_t> scansRejected(0);
+static std::atomic<uint64_t> scansForeign(0);   // Accepted, outside the BrainSAIT arc
+static std::atomic<uint64_t> badRequests(0);
+static std::atomic<uint64_t> logBytes(0);
+static std::atomic<uint32_t> openConnections(0);
+
+struct RevokedStore {
+  std::mutex lock;
+  std::vector<std::string> oids;     // Revocation order; version = count
+  OIDSet exact;
+  RevokedFilter filter;              // Holds every entry in oids
+  uint32_t capacity = 0;
+  uint32_t requestedGeneration = 0;  // -g; 0 keeps the saved generation
+  float bitsPerEntry = 10;
+  int fd = -1;
+  std::string metaPath;
+  uint32_t listHash = 2166136261u;   // FNV-1a over the lines in oids
+};
+
+static RevokedStore revoked;
+
+static uint32_t hashRevokedLine(uint32_t hash, const std::string& line) {
+  for (char c : line) hash = (hash ^ (uint8_t)c) * 16777619u;
+  return (hash ^ '\n') * 16777619u;
+}
+
+/**
+ * Print that appends to a std::string
+ */
+class BufferPrint : public Print {
+public:
+  explicit BufferPrint(std::string& buf) : _buf(buf) {}
+
+  size_t write(uint8_t c) override { _buf += (char)c; return 1; }
+  size_t write(const uint8_t* data, size_t n) override {
+    _buf.append((const char*)data, n);
+    return n;
+  }
+  using Print::write;
+
+private:
+  std::string& _buf;
+};
+
+static uint64_t monotonicUs() {
+  return hostMonotonicMicros();
+}
+
+static unsigned long long unixMillis() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (unsigned long long)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000ULL;
+}
+
+// ============== HTTP parsing ==============
+
+enum ParseResult {
+  PARSE_MORE,    // Request incomplete
+  PARSE_DONE,    // Request complete
+  PARSE_ERROR    // Reply with errorStatus and close
+};
+
+struct HttpRequest {
+  std::string method;
+  std::string path;
+  std::string device;
+  std::string apiKey;
+  std::string body;
+  bool keepAlive = true;
+  bool expectContinue = false;
+  bool headersDone = false;
+  size_t consumed = 0;       // Bytes of input this request used
+  int errorStatus = 0;
+};
+
+static bool headerIs(const char* line, size_t len, const char* name, const char** value) {
+  size_t n = strlen(name);
+  if (len <= n || line[n] != ':' || strncasecmp(line, name, n) != 0) return false;
+  const char* v = line + n + 1;
+  while (*v == ' ' || *v == '\t') v++;
+  *value = v;
+  return true;
+}
+
+static bool valueHas(const char* value, const char* lineEnd, const char* token) {
+  size_t n = strlen(token);
+  for (const char* p = value; p + n <= lineEnd; p++) {
+    if (strncasecmp(p, token, n) == 0) return true;
+  }
+  return false;
+}
+
+/**
+ * Decode a chunked body starting at pos
+ */
+static ParseResult decodeChunked(const std::string& in, size_t pos, HttpRequest& req) {
+  req.body.clear();
+  while (true) {
+    size_t lineEnd = in.find("\r\n", pos);
+    if (lineEnd == std::string::npos) {
+      if (in.size() - pos > 32) break;
+      return PARSE_MORE;
+    }
+
+    size_t size = 0;
+    size_t digits = 0;
+    for (size_t i = pos; i < lineEnd && isxdigit((unsigned char)in[i]); i++, digits++) {
+      char c = in[i];
+      size = size * 16 + (isdigit((unsigned char)c) ? c - '0' : (tolower(c) - 'a' + 10));
+      if (size > INGEST_MAX_BODY) {
+        req.errorStatus = 413;
+        return PARSE_ERROR;
+      }
+    }
+    if (digits == 0) break;
+    pos = lineEnd + 2;
+
+    if (size == 0) {
+      // Optional trailers, then an empty line
+      while (true) {
+        size_t end = in.find("\r\n", pos);
+        if (end == std::string::npos) return PARSE_MORE;
+        if (end == pos) {
+          req.consumed = pos + 2;
+          return PARSE_DONE;
+        }
+        pos = end + 2;
+      }
+    }
+
+    if (req.body.size() + size > INGEST_MAX_BODY) {
+      req.errorStatus = 413;
+      return PARSE_ERROR;
+    }
+    if (in.size() < pos + size + 2) return PARSE_MORE;
+    if (in.compare(pos + size, 2, "\r\n") != 0) break;
+    req.body.append(in, pos, size);
+    pos += size + 2;
+  }
+
+  req.errorStatus = 400;
+  return PARSE_ERROR;
+}
+
+/**
+ * Parse one request from the front of the connection's input
+ */
+static ParseResult parseRequest(const std::string& in, HttpRequest& req) {
+  size_t headerEnd = in.find("\r\n\r\n");
+  if (headerEnd == std::string::npos) {
+    if (in.size() > INGEST_MAX_HEADER) {
+      req.errorStatus = 431;
+      return PARSE_ERROR;
+    }
+    return PARSE_MORE;
+  }
+
+  // Request line: POST /oid/scan HTTP/1.1
+  size_t lineEnd = in.find("\r\n");
+  size_t sp1 = in.find(' ');
+  size_t sp2 = sp1 == std::string::npos ? sp1 : in.find(' ', sp1 + 1);
+  if (sp2 == std::string::npos || sp2 > lineEnd || in.compare(sp2 + 1, 7, "HTTP/1.") != 0) {
+    req.errorStatus = 400;
+    return PARSE_ERROR;
+  }
+  req.method.assign(in, 0, sp1);
+  req.path.assign(in, sp1 + 1, sp2 - sp1 - 1);
+  req.keepAlive = in.compare(sp2 + 1, 8, "HTTP/1.1") == 0;
+
+  long contentLength = 0;
+  bool chunked = false;
+  size_t pos = lineEnd + 2;
+  while (pos < headerEnd + 2) {
+    size_t end = in.find("\r\n", pos);
+    const char* line = in.data() + pos;
+    const char* stop = in.data() + end;
+    size_t len = end - pos;
+    const char* value;
+
+    if (headerIs(line, len, "Content-Length", &value)) {
+      contentLength = strtol(value, NULL, 10);
+    } else if (headerIs(line, len, "Transfer-Encoding", &value)) {
+      chunked = valueHas(value, stop, "chunked");
+    } else if (headerIs(line, len, "Connection", &value)) {
+      if (valueHas(value, stop, "close")) req.keepAlive = false;
+      else if (valueHas(value, stop, "keep-alive")) req.keepAlive = true;
+    } else if (headerIs(line, len, "Expect", &value)) {
+      req.expectContinue = valueHas(value, stop, "100-continue");
+    } else if (headerIs(line, len, "X-BrainSAIT-Device", &value)) {
+      req.device.assign(value, stop - value);
+    } else if (headerIs(line, len, "X-BrainSAIT-API-Key", &value)) {
+      req.apiKey.assign(value, stop - value);
+    }
+    pos = end + 2;
+  }
+  req.headersDone = true;
+
+  size_t bodyStart = headerEnd + 4;
+  if (chunked) return decodeChunked(in, bodyStart, req);
+
+  if (contentLength < 0 || contentLength > INGEST_MAX_BODY) {
+    req.errorStatus = contentLength < 0 ? 400 : 413;
+    return PARSE_ERROR;
+  }
+  if (in.size() < bodyStart + contentLength) return PARSE_MORE;
+  req.body.assign(in, bodyStart, contentLength);
+  req.consumed = bodyStart + contentLength;
+  return PARSE_DONE;
+}
+
+static const char* statusText(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 507: return "Insufficient Storage";
+    default:  return "Internal Server Error";
+  }
+}
+
+static void writeResponse(std::string& out, int status, const std::string& body, bool keepAlive,
+                          const char* contentType = "application/json") {
+  char head[192];
+  int n = snprintf(head, sizeof(head),
+                   "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n"
+                   "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+                   status, statusText(status), contentType, body.size(),
+                   keepAlive ? "keep-alive" : "close");
+  out.append(head, n);
+  out += body;
+}
+
+static void writeError(std::string& out, int status, const char* message, bool keepAlive) {
+  std::string body;
+  BufferPrint print(body);
+  JsonStreamWriter json(print);
+  json.beginObject();
+  json.member("error", message);
+  json.endObject();
+  writeResponse(out, status, body, keepAlive);
+}
+
+// ============== Workers ==============
+
+struct Connection {
+  int fd;
+  std::string in;
+  std::string out;
+  size_t outSent = 0;
+  uint64_t requestStartUs = 0;          // First byte of the request being read
+  std::vector<uint64_t> answered;       // Start times of responses queued this round
+  bool queued = false;                  // In the worker's ready list
+  bool writeWait = false;               // Waiting for EPOLLOUT
+  bool continueSent = false;
+  bool closeAfterWrite = false;
+  bool readShut = false;                // Peer sent FIN; no longer polled for input
+  bool closed = false;
+};
+
+struct Worker {
+  int id;
+  int listenFd;
+  int epollFd;
+  std::string logBuffer;                // Lines to append this round
+  std::string scratch;
+  std::vector<Connection*> ready;       // Connections with responses to send
+  std::vector<Connection*> closing;     // Closed this round, freed after it
+  std::mutex statsLock;
+  LatencyHistogram interval;            // Since the last stats line
+  std::thread thread;
+};
+
+static void closeConnection(Worker& w, Connection* conn) {
+  if (conn->closed) return;
+  epoll_ctl(w.epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+  close(conn->fd);
+  conn->closed = true;
+  openConnections--;
+  if (!conn->queued) w.closing.push_back(conn);   // Queued ones are freed by commitRound
+}
+
+static void updateEvents(Worker& w, Connection* conn) {
+  epoll_event ev;
+  ev.events = (conn->readShut ? 0 : (uint32_t)(EPOLLIN | EPOLLRDHUP)) |
+              (conn->writeWait ? (uint32_t)EPOLLOUT : 0);
+  ev.data.ptr = conn;
+  epoll_ctl(w.epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+static void setWriteWait(Worker& w, Connection* conn, bool wait) {
+  if (conn->writeWait == wait) return;
+  conn->writeWait = wait;
+  updateEvents(w, conn);
+}
+
+static void flushConnection(Worker& w, Connection* conn) {
+  while (conn->outSent < conn->out.size()) {
+    ssize_t n = send(conn->fd, conn->out.data() + conn->outSent,
+                     conn->out.size() - conn->outSent, MSG_NOSIGNAL);
+    if (n > 0) {
+      conn->outSent += n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      setWriteWait(w, conn, true);
+      return;
+    } else {
+      closeConnection(w, conn);
+      return;
+    }
+  }
+
+  conn->out.clear();
+  conn->outSent = 0;
+  setWriteWait(w, conn, false);
+  if (conn->closeAfterWrite) closeConnection(w, conn);
+}
+
+/**
+ * A scan whose "oid" is a dotted OID, and which namespace it is in
+ *
+ * The firmware uploads foreign OIDs too (processQRContent only warns), so
+ * they are accepted and logged with "namespace":"foreign".
+ */
+struct AcceptedScan {
+  JsonVariant scan;
+  bool brainsait;
+};
+
+static bool validScan(JsonVariant scan, std::vector<AcceptedScan>& accepted) {
+  OIDValue oid;
+  const char* text = scan["oid"].as<const char*>();
+  if (!text || !parseOIDValue(text, oid)) return false;
+  AcceptedScan entry = { scan, brainsaitRoot.isPrefixOf(oid) };
+  accepted.push_back(entry);
+  return true;
+}
+
+/**
+ * POST /oid/scan and /oid/scan/batch
+ */
+static void handleScans(Worker& w, HttpRequest& req, std::string& out) {
+  if (apiKey && req.apiKey != apiKey) {
+    writeError(out, 401, "invalid API key", req.keepAlive);
+    badRequests++;
+    return;
+  }
+
+  DynamicJsonDocument doc(req.body.size() * 3 + 1024);
+  DeserializationError error = deserializeJson(doc, req.body.data(), req.body.size());
+  if (error) {
+    writeError(out, 400, error.c_str(), req.keepAlive);
+    badRequests++;
+    return;
+  }
+
+  bool batch = doc.is<JsonArray>();
+  if ((!batch && !doc.is<JsonObject>()) || (!batch && req.path == "/oid/scan/batch")) {
+    writeError(out, 400, batch ? "expected a scan object" : "expected an array of scans",
+               req.keepAlive);
+    badRequests++;
+    return;
+  }
+
+  // Validate first so accepted scans get a contiguous sequence range
+  std::vector<AcceptedScan> accepted;
+  size_t rejected = 0;
+  if (batch) {
+    for (JsonVariant scan : doc.as<JsonArray>()) {
+      if (!validScan(scan, accepted)) rejected++;
+    }
+  } else {
+    if (!validScan(doc.as<JsonVariant>(), accepted)) rejected++;
+  }
+
+  scansRejected += rejected;
+  if (accepted.empty()) {
+    writeError(out, 400, batch ? "no scans with a valid OID" : "missing or invalid OID",
+               req.keepAlive);
+    return;
+  }
+
+  uint64_t firstSeq = nextSeq.fetch_add(accepted.size());
+  unsigned long long receivedAt = unixMillis();
+  BufferPrint logPrint(w.logBuffer);
+  BufferPrint scratchPrint(w.scratch);
+  size_t foreign = 0;
+  for (size_t i = 0; i < accepted.size(); i++) {
+    w.scratch.clear();
+    serializeJson(accepted[i].scan, scratchPrint);
+    if (!accepted[i].brainsait) foreign++;
+
+    JsonStreamWriter line(logPrint);
+    line.beginObject();
+    line.member("seq", (unsigned long)(firstSeq + i));
+    line.member("receivedAt", (unsigned long)receivedAt);
+    line.member("device", req.device.c_str());
+    line.member("namespace", accepted[i].brainsait ? "brainsait" : "foreign");
+    line.key("scan");
+    line.rawValue(w.scratch.data(), w.scratch.size());
+    line.endObject();
+    logPrint.write('\n');
+  }
+  scansAccepted += accepted.size();
+  scansForeign += foreign;
+
+  std::string body;
+  BufferPrint bodyPrint(body);
+  JsonStreamWriter json(bodyPrint);
+  json.beginObject();
+  json.member("status", "recorded");
+  if (batch) {
+    json.member("accepted", (unsigned long)accepted.size());
+    json.member("rejected", (unsigned long)rejected);
+    json.member("firstSeq", (unsigned long)firstSeq);
+  } else {
+    json.member("seq", (unsigned long)firstSeq);
+  }
+  json.endObject();
+  writeResponse(out, 201, body, req.keepAlive);
+}
+
+/**
+ * GET /oid/stats
+ */
+static void handleStats(HttpRequest& req, std::string& out) {
+  std::string body;
+  BufferPrint print(body);
+  JsonStreamWriter json(print);
+  json.beginObject();
+  json.member("uptimeMs", (unsigned long)((monotonicUs() - startedUs) / 1000));
+  json.member("requests", (unsigned long)totalRequests.load());
+  json.member("scansAccepted", (unsigned long)scansAccepted.load());
+  json.member("scansRejected", (unsigned long)scansRejected.load());
+  json.member("scansForeign", (unsigned long)scansForeign.load());
+  json.member("badRequests", (unsigned long)badRequests.load());
+  json.member("logBytes", (unsigned long)logBytes.load());
+  json.member("connections", (unsigned long)openConnections.load());
+  {
+    std::lock_guard<std::mutex> lock(revoked.lock);
+    json.member("revoked", (unsigned long)revoked.oids.size());
+  }
+  json.endObject();
+  writeResponse(out, 200, body, req.keepAlive);
+}
+
+// ============== Revocations ==============
+
+/**
+ * Build a filter over every revocation so far
+ */
+static bool buildRevokedFilter(RevokedFilter& filter, uint32_t capacity, uint32_t generation) {
+  if (!filter.createFor(capacity, revoked.bitsPerEntry, generation)) return false;
+  for (const std::string& text : revoked.oids) {
+    OIDValue oid;
+    parseOIDValue(text.c_str(), oid);
+    filter.add(oid);
+  }
+  filter.setVersion(revoked.oids.size());
+  return true;
+}
+
+/**
+ * Save the filter parameters: "capacity C generation G bits B entries N hash H"
+ *
+ * Written on every change. The hash covers the first N lines, so a restart
+ * can tell the saved lines were edited or removed.
+ */
+static bool saveRevokedMeta() {
+  std::string tmpPath = revoked.metaPath + ".tmp";
+  FILE* f = fopen(tmpPath.c_str(), "w");
+  if (!f) return false;
+  bool ok = fprintf(f, "capacity %lu generation %lu bits %.2f entries %lu hash %lu\n",
+                    (unsigned long)revoked.capacity, (unsigned long)revoked.filter.generation(),
+                    revoked.bitsPerEntry, (unsigned long)revoked.oids.size(),
+                    (unsigned long)revoked.listHash) > 0;
+  ok = fclose(f) == 0 && ok;
+  return ok && rename(tmpPath.c_str(), revoked.metaPath.c_str()) == 0;
+}
+
+struct RevokedMeta {
+  unsigned long capacity = 0;
+  unsigned long generation = 0;
+  float bitsPerEntry = 0;
+  unsigned long entries = 0;
+  unsigned long hash = 0;
+};
+
+static bool loadRevokedMeta(RevokedMeta& meta) {
+  FILE* f = fopen(revoked.metaPath.c_str(), "r");
+  if (!f) return false;
+  int n = fscanf(f, "capacity %lu generation %lu bits %f entries %lu hash %lu", &meta.capacity,
+                 &meta.generation, &meta.bitsPerEntry, &meta.entries, &meta.hash);
+  fclose(f);
+  return n == 5;
+}
+
+/**
+ * Build the startup filter, reusing the saved capacity and generation
+ * unless the bits per entry changed, saved lines were edited or removed,
+ * the list outgrew the capacity or -g asks for a new generation
+ */
+static bool initRevokedFilter() {
+  uint32_t count = revoked.oids.size();
+  RevokedMeta meta;
+  bool saved = loadRevokedMeta(meta);
+
+  // Lines appended since the save (e.g. before a crash) keep the prefix intact
+  uint32_t prefixHash = 2166136261u;
+  for (uint32_t i = 0; i < count; i++) {
+    if (i == meta.entries) prefixHash = revoked.listHash;
+    revoked.listHash = hashRevokedLine(revoked.listHash, revoked.oids[i]);
+  }
+  if (meta.entries == count) prefixHash = revoked.listHash;
+
+  bool reuse = saved && fabsf(meta.bitsPerEntry - revoked.bitsPerEntry) < 0.005f &&
+               meta.entries <= count && prefixHash == meta.hash && meta.capacity >= count &&
+               (!revoked.requestedGeneration || revoked.requestedGeneration == meta.generation);
+
+  uint32_t capacity = meta.capacity;
+  uint32_t generation = meta.generation;
+  if (!reuse) {
+    capacity = revokedFilterCapacity(count, revoked.bitsPerEntry);
+    if (capacity == 0) return false;
+    // Without a saved generation, the clock keeps it from repeating an old one
+    generation = revoked.requestedGeneration ? revoked.requestedGeneration
+                 : saved                     ? meta.generation + 1
+                                             : (uint32_t)time(NULL);
+  }
+
+  RevokedFilter fresh;
+  if (!buildRevokedFilter(fresh, capacity, generation)) return false;
+  revoked.filter.swap(fresh);
+  revoked.capacity = capacity;
+  if (!saveRevokedMeta()) {
+    fprintf(stderr, "[Ingest] Cannot write %s: %s\n", revoked.metaPath.c_str(), strerror(errno));
+  }
+  return true;
+}
+
+enum RevokeResult {
+  REVOKE_ADDED,
+  REVOKE_SKIPPED,     // Bad or already revoked OID
+  REVOKE_FULL,        // Filter cannot grow within REVOKED_FILTER_MAX_BYTES
+  REVOKE_FAILED       // Could not append to the revocations file
+};
+
+/**
+ * Record one revocation (caller holds the lock)
+ *
+ * When the filter is full a larger one, with a new generation, is built
+ * before anything is written, so a revocation is only persisted once the
+ * filter can hold it.
+ */
+static RevokeResult addRevoked(const char* text, bool persist) {
+  OIDValue oid;
+  if (!text || !parseOIDValue(text, oid) || revoked.exact.contains(oid)) return REVOKE_SKIPPED;
+
+  RevokedFilter grown;
+  uint32_t capacity = revoked.capacity;
+  if (revoked.oids.size() >= capacity) {
+    capacity = revokedFilterCapacity(revoked.oids.size() + 1, revoked.bitsPerEntry);
+    if (capacity == 0 ||
+        !buildRevokedFilter(grown, capacity, revoked.filter.generation() + 1)) {
+      return REVOKE_FULL;
+    }
+  }
+
+  if (persist && revoked.fd >= 0) {
+    std::string line = std::string(text) + "\n";
+    if (write(revoked.fd, line.data(), line.size()) != (ssize_t)line.size()) return REVOKE_FAILED;
+  }
+
+  revoked.oids.push_back(text);
+  revoked.exact.insert(oid);
+  revoked.listHash = hashRevokedLine(revoked.listHash, revoked.oids.back());
+  if (grown.ready()) {
+    revoked.filter.swap(grown);   // New generation; devices re-download
+    revoked.capacity = capacity;
+  }
+  revoked.filter.add(oid);
+  revoked.filter.setVersion(revoked.oids.size());
+  return REVOKE_ADDED;
+}
+
+static bool loadRevokedFile(const char* path) {
+  revoked.fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (revoked.fd < 0) return false;
+  revoked.metaPath = std::string(path) + ".meta";
+
+  std::string text;
+  char buf[65536];
+  ssize_t n;
+  off_t offset = 0;
+  while ((n = pread(revoked.fd, buf, sizeof(buf), offset)) > 0) {
+    text.append(buf, n);
+    offset += n;
+  }
+
+  std::vector<OIDValue> values;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(pos, end - pos);
+    while (!line.empty() && isspace((unsigned char)line.back())) line.pop_back();
+    pos = end + 1;
+    if (line.empty() || line[0] == '#') continue;
+
+    OIDValue oid;
+    if (!parseOIDValue(line.c_str(), oid)) {
+      fprintf(stderr, "[Ingest] Skipping bad revoked OID '%s'\n", line.c_str());
+      continue;
+    }
+    revoked.oids.push_back(line);
+    values.push_back(oid);
+  }
+  revoked.exact.assign(values);
+  if (!initRevokedFilter()) {
+    fprintf(stderr, "[Ingest] %u revocations do not fit a %lu byte filter at %.1f bits/entry\n",
+            (unsigned)revoked.oids.size(), (unsigned long)REVOKED_FILTER_MAX_BYTES,
+            revoked.bitsPerEntry);
+    return false;
+  }
+  return true;
+}
+
+static void handleRevoked(HttpRequest& req, std::string& out) {
+  std::string body;
+  BufferPrint print(body);
+  JsonStreamWriter json(print);
+  const std::string prefix = "/oid/revoked/";
+
+  if (apiKey && req.apiKey != apiKey) {
+    writeError(out, 401, "invalid API key", req.keepAlive);
+    badRequests++;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(revoked.lock);
+
+  if (req.method == "POST" && req.path == "/oid/revoked") {
+    DynamicJsonDocument doc(req.body.size() * 3 + 1024);
+    if (deserializeJson(doc, req.body.data(), req.body.size()) || !doc.is<JsonArray>()) {
+      writeError(out, 400, "expected an array of OIDs", req.keepAlive);
+      badRequests++;
+      return;
+    }
+    unsigned long added = 0;
+    RevokeResult result = REVOKE_ADDED;
+    for (JsonVariant oid : doc.as<JsonArray>()) {
+      result = addRevoked(oid.as<const char*>(), true);
+      if (result == REVOKE_ADDED) added++;
+      if (result == REVOKE_FULL || result == REVOKE_FAILED) break;
+    }
+
+    // On failure the OIDs before the failing one stay revoked
+    int status = 201;
+    json.beginObject();
+    if (result == REVOKE_FULL) {
+      status = 507;
+      json.member("error", "revoked filter full");
+    } else if (result == REVOKE_FAILED) {
+      status = 500;
+      json.member("error", "cannot write revocations file");
+    }
+    json.member("added", added);
+    json.member("version", (unsigned long)revoked.oids.size());
+    json.member("generation", (unsigned long)revoked.filter.generation());
+    json.endObject();
+    if (status != 201) {
+      fprintf(stderr, "[Ingest] Revocation failed after %lu added: %s\n", added,
+              result == REVOKE_FULL ? "filter full" : strerror(errno));
+    }
+    if (added && !saveRevokedMeta()) {
+      fprintf(stderr, "[Ingest] Cannot write %s: %s\n", revoked.metaPath.c_str(), strerror(errno));
+    }
+    writeResponse(out, status, body, req.keepAlive);
+    return;
+  }
+
+  if (req.method != "GET" || req.path.compare(0, prefix.size(), prefix) != 0) {
+    writeError(out, req.method != "GET" ? 405 : 404, req.method != "GET" ? "method not allowed"
+                                                                       : "not found",
+               req.keepAlive);
+    badRequests++;
+    return;
+  }
+  std::string rest = req.path.substr(prefix.size());
+
+  if (rest == "filter") {
+    revoked.filter.save(print);
+    writeResponse(out, 200, body, req.keepAlive, "application/octet-stream");
+    return;
+  }
+
+  if (rest.compare(0, 6, "delta?") == 0) {
+    unsigned long generation = 0;
+    unsigned long since = 0;
+    if (sscanf(rest.c_str(), "delta?generation=%lu&since=%lu", &generation, &since) != 2) {
+      writeError(out, 400, "expected generation and since", req.keepAlive);
+      badRequests++;
+      return;
+    }
+    if (generation != revoked.filter.generation() || since > revoked.oids.size()) {
+      writeError(out, 409, "filter rebuilt, fetch a new snapshot", req.keepAlive);
+      return;
+    }
+    print.printf("generation %lu version %lu\n", generation, (unsigned long)revoked.oids.size());
+    for (size_t i = since; i < revoked.oids.size(); i++) {
+      body += revoked.oids[i];
+      body += '\n';
+    }
+    writeResponse(out, 200, body, req.keepAlive, "text/plain");
+    return;
+  }
+
+  OIDValue oid;
+  if (!parseOIDValue(rest.c_str(), oid)) {
+    writeError(out, 400, "invalid OID", req.keepAlive);
+    badRequests++;
+    return;
+  }
+  bool isRevoked = revoked.exact.contains(oid);
+  json.beginObject();
+  json.member("oid", rest.c_str());
+  json.member("revoked", isRevoked);
+  json.endObject();
+  writeResponse(out, isRevoked ? 200 : 404, body, req.keepAlive);
+}
+
+static void route(Worker& w, HttpRequest& req, std::string& out) {
+  totalRequests++;
+  if (req.path == "/oid/scan" || req.path == "/oid/scan/batch") {
+    if (req.method == "POST") {
+      handleScans(w, req, out);
+      return;
+    }
+  } else if (req.path == "/oid/stats") {
+    if (req.method == "GET") {
+      handleStats(req, out);
+      return;
+    }
+  } else if (req.path.compare(0, 12, "/oid/revoked") == 0) {
+    handleRevoked(req, out);
+    return;
+  } else {
+    writeError(out, 404, "not found", req.keepAlive);
+    badRequests++;
+    return;
+  }
+  writeError(out, 405, "method not allowed", req.keepAlive);
+  badRequests++;
+}
+
+static void queueResponse(Worker& w, Connection* conn) {
+  conn->answered.push_back(conn->requestStartUs);
+  if (!conn->queued) {
+    conn->queued = true;
+    w.ready.push_back(conn);
+  }
+}
+
+/**
+ * Answer every complete request in the connection's input
+ */
+static void processInput(Worker& w, Connection* conn) {
+  while (!conn->closeAfterWrite && !conn->in.empty()) {
+    HttpRequest req;
+    ParseResult result = parseRequest(conn->in, req);
+
+    if (result == PARSE_MORE) {
+      if (req.headersDone && req.expectContinue && !conn->continueSent) {
+        conn->out += "HTTP/1.1 100 Continue\r\n\r\n";
+        conn->continueSent = true;
+        flushConnection(w, conn);
+      }
+      return;
+    }
+
+    if (result == PARSE_ERROR) {
+      totalRequests++;
+      badRequests++;
+      writeError(conn->out, req.errorStatus, statusText(req.errorStatus), false);
+      conn->in.clear();
+      conn->closeAfterWrite = true;
+    } else {
+      route(w, req, conn->out);
+      conn->in.erase(0, req.consumed);
+      if (!req.keepAlive) conn->closeAfterWrite = true;
+    }
+
+    queueResponse(w, conn);
+    conn->continueSent = false;
+    conn->requestStartUs = monotonicUs();   // Pipelined bytes already buffered
+  }
+}
+
+static void readConnection(Worker& w, Connection* conn) {
+  char buf[INGEST_READ_CHUNK];
+  bool peerClosed = false;
+
+  while (true) {
+    ssize_t n = recv(conn->fd, buf, sizeof(buf), 0);
+    if (n > 0) {
+      if (conn->in.empty()) conn->requestStartUs = monotonicUs();
+      conn->in.append(buf, n);
+      if ((size_t)n < sizeof(buf)) break;
+    } else if (n == 0) {
+      peerClosed = true;
+      break;
+    } else if (errno == EINTR) {
+      continue;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      break;
+    } else {
+      closeConnection(w, conn);
+      return;
+    }
+  }
+
+  processInput(w, conn);
+
+  if (peerClosed) {
+    // Still answer what was sent before the client's FIN. The socket stays
+    // readable (EOF) until closed, so stop polling it for input, or a slow
+    // reader's pending response would spin the loop.
+    if (conn->queued || !conn->out.empty()) {
+      conn->closeAfterWrite = true;
+      conn->readShut = true;
+      updateEvents(w, conn);
+    } else {
+      closeConnection(w, conn);
+    }
+  }
+}
+
+static void acceptConnections(Worker& w) {
+  while (true) {
+    int fd = accept4(w.listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      return;   // EAGAIN, or out of descriptors until the next round
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    Connection* conn = new Connection();
+    conn->fd = fd;
+    epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.ptr = conn;
+    epoll_ctl(w.epollFd, EPOLL_CTL_ADD, fd, &ev);
+    openConnections++;
+  }
+}
+
+/**
+ * Append this round's log lines, then release its responses
+ */
+static void commitRound(Worker& w) {
+  bool logged = true;
+  if (!w.logBuffer.empty()) {
+    size_t done = 0;
+    while (done < w.logBuffer.size()) {
+      ssize_t n = write(logFd, w.logBuffer.data() + done, w.logBuffer.size() - done);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        fprintf(stderr, "[Ingest] Log write failed: %s\n", strerror(errno));
+        logged = false;
+        break;
+      }
+      done += n;
+    }
+    if (logged && syncLog && fdatasync(logFd) != 0) {
+      fprintf(stderr, "[Ingest] fdatasync failed: %s\n", strerror(errno));
+      logged = false;
+    }
+    logBytes += done;
+    w.logBuffer.clear();
+  }
+
+  uint64_t now = monotonicUs();
+  {
+    std::lock_guard<std::mutex> lock(w.statsLock);
+    for (Connection* conn : w.ready) {
+      for (uint64_t start : conn->answered) w.interval.record((uint32_t)(now - start));
+    }
+  }
+
+  for (Connection* conn : w.ready) {
+    conn->queued = false;
+    conn->answered.clear();
+    if (conn->closed) {
+      delete conn;
+    } else if (!logged) {
+      closeConnection(w, conn);   // Never acknowledge scans that were not stored
+    } else {
+      flushConnection(w, conn);
+    }
+  }
+  w.ready.clear();
+
+  for (Connection* conn : w.closing) delete conn;
+  w.closing.clear();
+}
+
+static void runWorker(Worker& w) {
+  epoll_event events[INGEST_MAX_EVENTS];
+
+  while (running) {
+    int n = epoll_wait(w.epollFd, events, INGEST_MAX_EVENTS, 100);
+    for (int i = 0; i < n; i++) {
+      Connection* conn = (Connection*)events[i].data.ptr;
+      if (!conn) {
+        acceptConnections(w);
+        continue;
+      }
+
+      uint32_t ev = events[i].events;
+      if (ev & EPOLLOUT) flushConnection(w, conn);
+      if (conn->closed) continue;
+      if (conn->readShut) {
+        // Only HUP/ERR can arrive now: the response can no longer be delivered
+        if (ev & (EPOLLHUP | EPOLLERR)) closeConnection(w, conn);
+      } else if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        readConnection(w, conn);
+      }
+    }
+    commitRound(w);
+  }
+}
+
+static int openListener(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 1024) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// ============== Main ==============
+
+/**
+ * Continue sequence numbers after the lines already in the log
+ */
+static uint64_t countLogLines(int fd) {
+  uint64_t lines = 0;
+  char buf[65536];
+  ssize_t n;
+  off_t offset = 0;
+  while ((n = pread(fd, buf, sizeof(buf), offset)) > 0) {
+    for (ssize_t i = 0; i < n; i++) lines += buf[i] == '\n';
+    offset += n;
+  }
+  return lines;
+}
+
+static void printLatency(const char* label, const LatencyHistogram& h) {
+  printf("%s min=%lu avg=%lu p50=%lu p90=%lu p99=%lu p99.9=%lu max=%lu\n", label,
+         (unsigned long)h.minUs(), (unsigned long)h.meanUs(), (unsigned long)h.percentile(50),
+         (unsigned long)h.percentile(90), (unsigned long)h.percentile(99),
+         (unsigned long)h.percentile(99.9f), (unsigned long)h.maxUs());
+}
+
+static void onSignal(int) {
+  running = false;
+}
+
+static void usage(const char* name) {
+  fprintf(stderr,
+          "Usage: %s [-p port] [-t threads] [-l log file] [-k api key] [-i stats interval s] [-f]\n"
+          "          [-r revoked file] [-b filter bits per entry] [-g new generation]\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  uint16_t port = INGEST_DEFAULT_PORT;
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* logPath = "scans.ndjson";
+  unsigned statsInterval = 5;
+  const char* revokedPath = "revoked.txt";
+
+  int opt;
+  while ((opt = getopt(argc, argv, "p:t:l:k:i:fr:b:g:")) != -1) {
+    switch (opt) {
+      case 'p': port = (uint16_t)atoi(optarg); break;
+      case 't': threads = (unsigned)atoi(optarg); break;
+      case 'l': logPath = optarg; break;
+      case 'k': apiKey = optarg; break;
+      case 'i': statsInterval = (unsigned)atoi(optarg); break;
+      case 'f': syncLog = true; break;
+      case 'r': revokedPath = optarg; break;
+      case 'b': revoked.bitsPerEntry = atof(optarg); break;
+      case 'g': revoked.requestedGeneration = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (threads == 0) threads = 1;
+
+  parseOIDValue(BRAINSAIT_ROOT, brainsaitRoot);
+
+  logFd = open(logPath, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (logFd < 0) {
+    fprintf(stderr, "[Ingest] Cannot open %s: %s\n", logPath, strerror(errno));
+    return 1;
+  }
+  nextSeq = countLogLines(logFd) + 1;
+
+  if (!loadRevokedFile(revokedPath)) {
+    fprintf(stderr, "[Ingest] Cannot load revocations from %s\n", revokedPath);
+    return 1;
+  }
+
+  std::vector<Worker*> workers;
+  for (unsigned i = 0; i < threads; i++) {
+    Worker* w = new Worker();
+    w->id = i;
+    w->listenFd = openListener(port);
+    if (w->listenFd < 0) {
+      fprintf(stderr, "[Ingest] Cannot listen on port %u: %s\n", port, strerror(errno));
+      return 1;
+    }
+    w->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    epoll_ctl(w->epollFd, EPOLL_CTL_ADD, w->listenFd, &ev);
+    workers.push_back(w);
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  startedUs = monotonicUs();
+  for (Worker* w : workers) w->thread = std::thread(runWorker, std::ref(*w));
+
+  printf("[Ingest] Listening on :%u with %u worker(s), log %s (next seq %llu%s)\n", port, threads,
+         logPath, (unsigned long long)nextSeq.load(), syncLog ? ", fdatasync" : "");
+  printf("[Ingest] Revoked: %u OIDs from %s, filter %u bytes, k=%u, generation %lu\n",
+         (unsigned)revoked.oids.size(), revokedPath, (unsigned)revoked.filter.sizeBytes(),
+         (unsigned)revoked.filter.hashCount(), (unsigned long)revoked.filter.generation());
+  fflush(stdout);
+
+  LatencyHistogram total;
+  uint64_t lastRequests = 0;
+  uint64_t lastScans = 0;
+  uint64_t lastReportUs = startedUs;
+
+  while (running) {
+    delay(100);
+    uint64_t now = monotonicUs();
+    if (statsInterval == 0 || now - lastReportUs < statsInterval * 1000000ULL) continue;
+
+    LatencyHistogram interval;
+    for (Worker* w : workers) {
+      std::lock_guard<std::mutex> lock(w->statsLock);
+      interval.merge(w->interval);
+      w->interval.reset();
+    }
+    total.merge(interval);
+
+    double seconds = (now - lastReportUs) / 1e6;
+    uint64_t requests = totalRequests.load();
+    uint64_t scans = scansAccepted.load();
+    printf("[Ingest] %.0f req/s, %.0f scans/s, conns=%u, latency us p50=%lu p99=%lu max=%lu\n",
+           (requests - lastRequests) / seconds, (scans - lastScans) / seconds,
+           openConnections.load(), (unsigned long)interval.percentile(50),
+           (unsigned long)interval.percentile(99), (unsigned long)interval.maxUs());
+    fflush(stdout);
+    lastRequests = requests;
+    lastScans = scans;
+    lastReportUs = now;
+  }
+
+  for (Worker* w : workers) {
+    w->thread.join();
+    total.merge(w->interval);
+  }
+
+  double seconds = (monotonicUs() - startedUs) / 1e6;
+  printf("\n[Ingest] Stopped after %.1f s\n", seconds);
+  printf("[Ingest] Requests: %llu (%.0f req/s), bad requests: %llu\n",
+         (unsigned long long)totalRequests.load(), totalRequests.load() / seconds,
+         (unsigned long long)badRequests.load());
+  printf("[Ingest] Scans: accepted=%llu (foreign=%llu) rejected=%llu, log %s +%llu bytes\n",
+         (unsigned long long)scansAccepted.load(), (unsigned long long)scansForeign.load(),
+         (unsigned long long)scansRejected.load(), logPath, (unsigned long long)logBytes.load());
+  printLatency("[Ingest] Latency (us):", total);
+
+  close(logFd);
+  return 0;
+}
@@ -0,0 +1,34 @@
+# BrainSAIT OID Scanner - Sketch to C++
+#
+# Converts an Arduino sketch the way the Arduino and PlatformIO builders
+# do: a prototype for every top-level function is inserted just before the
+# first function definition, so types used in signatures must be declared
+# above it. #line directives keep diagnostics pointing into the .ino.
+#
+#   awk -f ino2cpp.awk sketch.ino sketch.ino > sketch.cpp
+
+function isDefinition(line) {
+  return line ~ /^[A-Za-z_][A-Za-z0-9_:<>*& ]*[ *&][A-Za-z_][A-Za-z0-9_]*\(.*\) *\{$/
+}
+
+NR == FNR {
+  if (isDefinition($0)) {
+    if (!first) first = FNR
+    proto = $0
+    sub(/ *\{$/, ";", proto)
+    protos = protos proto "\n"
+  }
+  next
+}
+
+FNR == 1 {
+  print "#include <Arduino.h>"
+  printf "#line 1 \"%s\"\n", FILENAME
+}
+
+FNR == first {
+  printf "%s", protos
+  printf "#line %d \"%s\"\n", FNR, FILENAME
+}
+
+{ print }
@@ -0,0 +1,503 @@
+/**
+ * BrainSAIT OID Scanner - Label Sheet Audit
+ *
+ * Checks photographed sheets of printed OID labels before deployment.
+ * Every code in every image goes through the scanner's own path: quirc
+ * decode (qr_decode.h), payload classification (parseScanPayload) and
+ * the namespace check processQRContent applies (scanNamespace). Each
+ * label is reported with its OID, format, namespace, QR version and ECC
+ * level; OIDs printed on more than one label are flagged.
+ *
+ * Images are 8-bit PGM (P5), PPM (P6, converted to gray) or raw
+ * grayscale frames as the ESP32-CAM captures them (-s WxH). Convert
+ * photos first, e.g. `convert sheet.jpg sheet.pgm`.
+ *
+ * Files are memory-mapped by the worker that decodes them. Each worker
+ * owns a quirc instance and a deque of images: it takes from the back of
+ * its own deque and steals from the front of the others, so a few large
+ * sheets do not leave the other cores idle. -S repeats the audit at 1, 2,
+ * 4, ... threads and prints the throughput at each.
+ *
+ * Report (tab-separated, in input order):
+ *   image  label  status  format  namespace  oid  version  ecc  mirrored  detail
+ *
+ * Usage: label_audit [-t threads] [-s WxH] [-n labels per image] [-o report]
+ *                    [-S (scaling run)] <image|directory>...
+ *
+ * Exits 1 if any label fails or an image has fewer than -n labels.
+ */
+
+#include <Arduino.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "oid_utils.h"
+#include "scan_parser.h"
+#include "qr_decode.h"
+#include "load_test.h"
+
+// ============== Results ==============
+
+struct LabelResult {
+  int index;
+  bool ok;
+  std::string format;
+  std::string ns;
+  std::string oid;
+  int version;
+  char ecc;
+  bool mirrored;
+  std::string detail;
+};
+
+struct ImageResult {
+  int width = 0;
+  int height = 0;
+  std::string error;      // Image could not be read or decoded
+  std::vector<LabelResult> labels;
+};
+
+struct AuditStats {
+  double seconds = 0;
+  uint64_t images = 0;
+  uint64_t labels = 0;
+  uint64_t pixels = 0;
+  uint64_t steals = 0;
+  LatencyHistogram perImage;
+};
+
+// ============== Image input ==============
+
+struct MappedImage {
+  void* map = MAP_FAILED;
+  size_t mapSize = 0;
+  const uint8_t* pixels = NULL;
+  int width = 0;
+  int height = 0;
+  int channels = 1;
+
+  ~MappedImage() {
+    if (map != MAP_FAILED) munmap(map, mapSize);
+  }
+};
+
+static int rawWidth = 0;
+static int rawHeight = 0;
+
+// Read one PNM header number, skipping whitespace and comments
+static bool pnmNumber(const uint8_t*& p, const uint8_t* end, int& value) {
+  while (p < end) {
+    if (*p == '#') {
+      while (p < end && *p != '\n') p++;
+    } else if (isspace(*p)) {
+      p++;
+    } else {
+      break;
+    }
+  }
+  if (p >= end || !isdigit(*p)) return false;
+  value = 0;
+  while (p < end && isdigit(*p) && value < 100000) value = value * 10 + (*p++ - '0');
+  return true;
+}
+
+static bool mapImage(const std::string& path, MappedImage& img, std::string& error) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0 || st.st_size == 0) {
+    error = fd < 0 ? strerror(errno) : "empty file";
+    if (fd >= 0) close(fd);
+    return false;
+  }
+  img.mapSize = st.st_size;
+  img.map = mmap(NULL, img.mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (img.map == MAP_FAILED) {
+    error = strerror(errno);
+    return false;
+  }
+  madvise(img.map, img.mapSize, MADV_SEQUENTIAL);
+
+  const uint8_t* p = (const uint8_t*)img.map;
+  const uint8_t* end = p + img.mapSize;
+  if (img.mapSize > 2 && p[0] == 'P' && (p[1] == '5' || p[1] == '6')) {
+    img.channels = p[1] == '5' ? 1 : 3;
+    p += 2;
+    int maxval;
+    if (!pnmNumber(p, end, img.width) || !pnmNumber(p, end, img.height) ||
+        !pnmNumber(p, end, maxval) || p >= end) {
+      error = "bad PNM header";
+      return false;
+    }
+    if (maxval > 255) {
+      error = "16-bit PNM not supported";
+      return false;
+    }
+    p++;   // Single whitespace before the raster
+  } else if (rawWidth > 0) {
+    img.width = rawWidth;
+    img.height = rawHeight;
+  } else {
+    error = "not a P5/P6 image (use -s WxH for raw frames)";
+    return false;
+  }
+
+  if (img.width <= 0 || img.height <= 0 ||
+      (size_t)(end - p) < (size_t)img.width * img.height * img.channels) {
+    error = "truncated image";
+    return false;
+  }
+  img.pixels = p;
+  return true;
+}
+
+// ============== Audit ==============
+
+struct Worker {
+  std::mutex lock;
+  std::deque<size_t> queue;     // Image indices
+  struct quirc* qr = NULL;
+  std::vector<uint8_t> gray;    // P6 conversion buffer
+  AuditStats stats;
+  std::thread thread;
+};
+
+static std::vector<std::string> paths;
+static std::vector<ImageResult> results;
+
+static bool takeLocal(Worker& w, size_t& index) {
+  std::lock_guard<std::mutex> lock(w.lock);
+  if (w.queue.empty()) return false;
+  index = w.queue.back();
+  w.queue.pop_back();
+  return true;
+}
+
+static bool steal(std::vector<Worker>& workers, size_t self, size_t& index) {
+  for (size_t i = 1; i < workers.size(); i++) {
+    Worker& victim = workers[(self + i) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.lock);
+    if (!victim.queue.empty()) {
+      index = victim.queue.front();
+      victim.queue.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Classify one decoded payload as processQRContent would
+ */
+static void checkLabel(const QRCodeResult& code, LabelResult& label) {
+  label.version = code.data.version;
+  label.ecc = qrEccLevelName(code.data.ecc_level);
+  label.mirrored = code.mirrored;
+
+  String content((const char*)code.data.payload);
+  OIDData scan;
+  ScanFormat format = parseScanPayload(content, scan);
+  ScanNamespace ns = scanNamespace(scan);
+  label.format = scanFormatName(format);
+  label.ns = scanNamespaceName(ns);
+  label.oid = scan.valid ? scan.oid.c_str() : "";
+
+  label.ok = format != SCAN_FORMAT_UNKNOWN && format != SCAN_FORMAT_JSON_OTHER &&
+             ns == SCAN_NAMESPACE_BRAINSAIT;
+  if (format == SCAN_FORMAT_UNKNOWN || format == SCAN_FORMAT_JSON_OTHER) {
+    label.detail = "no OID in payload";
+  } else if (ns != SCAN_NAMESPACE_BRAINSAIT) {
+    label.detail = std::string("OID is ") + label.ns;
+  } else if (code.mirrored) {
+    label.detail = "printed mirrored";
+  }
+}
+
+static void auditImage(Worker& w, size_t index) {
+  ImageResult& result = results[index];
+  result = ImageResult();
+
+  MappedImage img;
+  if (!mapImage(paths[index], img, result.error)) return;
+  result.width = img.width;
+  result.height = img.height;
+
+  const uint8_t* gray = img.pixels;
+  if (img.channels == 3) {
+    w.gray.resize((size_t)img.width * img.height);
+    const uint8_t* rgb = img.pixels;
+    for (size_t i = 0; i < w.gray.size(); i++, rgb += 3) {
+      w.gray[i] = (uint8_t)((rgb[0] * 77 + rgb[1] * 150 + rgb[2] * 29) >> 8);
+    }
+    gray = w.gray.data();
+  }
+
+  if (!loadQRFrame(w.qr, gray, img.width, img.height)) {
+    result.error = "quirc_resize failed (image too large?)";
+    return;
+  }
+
+  static thread_local QRCodeResult code;   // 8.9 KB payload buffer
+  int count = quirc_count(w.qr);
+  for (int i = 0; i < count; i++) {
+    decodeQRCode(w.qr, i, code);
+    LabelResult label = LabelResult();
+    label.index = i + 1;
+    if (code.error == QUIRC_SUCCESS) {
+      checkLabel(code, label);
+    } else {
+      label.ok = false;
+      label.ecc = '-';
+      label.detail = std::string("decode: ") + quirc_strerror(code.error);
+    }
+    result.labels.push_back(label);
+  }
+
+  w.stats.labels += count;
+  w.stats.pixels += (uint64_t)img.width * img.height;
+}
+
+static void runWorker(std::vector<Worker>& workers, size_t self) {
+  Worker& w = workers[self];
+  size_t index;
+  while (true) {
+    if (!takeLocal(w, index)) {
+      // No images are added once the audit starts, so one empty sweep means done
+      if (!steal(workers, self, index)) break;
+      w.stats.steals++;
+    }
+    unsigned long start = micros();
+    auditImage(w, index);
+    w.stats.perImage.record(micros() - start);
+    w.stats.images++;
+  }
+}
+
+/**
+ * Audit every image in paths with `threads` workers
+ * @return false if a quirc instance cannot be allocated
+ */
+static bool runAudit(size_t threads, AuditStats& total) {
+  results.assign(paths.size(), ImageResult());
+  std::vector<Worker> workers(threads);
+
+  // Contiguous blocks: owners work back to front, thieves front to back
+  for (size_t t = 0; t < threads; t++) {
+    for (size_t i = paths.size() * t / threads; i < paths.size() * (t + 1) / threads; i++) {
+      workers[t].queue.push_back(i);
+    }
+    workers[t].qr = quirc_new();
+    if (!workers[t].qr) {
+      for (size_t i = 0; i < t; i++) quirc_destroy(workers[i].qr);
+      return false;
+    }
+  }
+
+  total = AuditStats();
+  total.perImage.reset();
+  unsigned long start = micros();
+  for (size_t t = 0; t < threads; t++) {
+    workers[t].stats.perImage.reset();
+    workers[t].thread = std::thread(runWorker, std::ref(workers), t);
+  }
+  for (Worker& w : workers) {
+    w.thread.join();
+    quirc_destroy(w.qr);
+    total.images += w.stats.images;
+    total.labels += w.stats.labels;
+    total.pixels += w.stats.pixels;
+    total.steals += w.stats.steals;
+    total.perImage.merge(w.stats.perImage);
+  }
+  total.seconds = (micros() - start) / 1e6;
+  return true;
+}
+
+/**
+ * Flag OIDs printed on more than one label
+ */
+static void markDuplicates() {
+  std::unordered_map<std::string, std::string> firstSeen;
+  for (size_t i = 0; i < results.size(); i++) {
+    for (LabelResult& label : results[i].labels) {
+      if (label.oid.empty()) continue;
+      std::string where = paths[i] + "#" + std::to_string(label.index);
+      auto inserted = firstSeen.emplace(label.oid, where);
+      if (!inserted.second) {
+        label.ok = false;
+        label.detail = "duplicate of " + inserted.first->second;
+      }
+    }
+  }
+}
+
+// ============== Report ==============
+
+/**
+ * Write the per-label report
+ * @return Failed labels plus images with errors or missing labels
+ */
+static size_t writeReport(FILE* out, int expectedLabels) {
+  size_t failures = 0;
+  fprintf(out, "# image\tlabel\tstatus\tformat\tnamespace\toid\tversion\tecc\tmirrored\tdetail\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const ImageResult& r = results[i];
+    const char* path = paths[i].c_str();
+    if (!r.error.empty()) {
+      fprintf(out, "%s\t-\terror\t-\t-\t-\t-\t-\t-\t%s\n", path, r.error.c_str());
+      failures++;
+      continue;
+    }
+    for (const LabelResult& l : r.labels) {
+      fprintf(out, "%s\t%d\t%s\t%s\t%s\t%s\t", path, l.index, l.ok ? "ok" : "fail",
+              l.format.empty() ? "-" : l.format.c_str(), l.ns.empty() ? "-" : l.ns.c_str(),
+              l.oid.empty() ? "-" : l.oid.c_str());
+      if (l.version > 0) {
+        fprintf(out, "%d\t%c\t%s\t", l.version, l.ecc, l.mirrored ? "yes" : "no");
+      } else {
+        fprintf(out, "-\t-\t-\t");
+      }
+      fprintf(out, "%s\n", l.detail.empty() ? "-" : l.detail.c_str());
+      failures += !l.ok;
+    }
+    if (expectedLabels > 0 && (int)r.labels.size() < expectedLabels) {
+      fprintf(out, "%s\t-\tmissing\t-\t-\t-\t-\t-\t-\tfound %zu of %d labels\n", path,
+              r.labels.size(), expectedLabels);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+static void printThroughput(const AuditStats& s, size_t threads) {
+  fprintf(stderr, "[Audit] %zu thread(s): %.2f s, %.1f images/s, %.0f labels/s, %.1f MP/s, "
+          "%llu steals\n", threads, s.seconds, s.images / s.seconds, s.labels / s.seconds,
+          s.pixels / 1e6 / s.seconds, (unsigned long long)s.steals);
+  fprintf(stderr, "[Audit] Per image (ms): p50=%.1f p90=%.1f p99=%.1f max=%.1f\n",
+          s.perImage.percentile(50) / 1000.0, s.perImage.percentile(90) / 1000.0,
+          s.perImage.percentile(99) / 1000.0, s.perImage.maxUs() / 1000.0);
+}
+
+/**
+ * Re-run the audit at 1, 2, 4, ... threads up to maxThreads
+ */
+static bool runScaling(size_t maxThreads) {
+  std::vector<size_t> counts;
+  for (size_t t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+  counts.push_back(maxThreads);
+
+  // Untimed pass so every run reads the images from the page cache
+  AuditStats stats;
+  if (!runAudit(maxThreads, stats)) return false;
+
+  printf("%zu images, %.1f MP, %llu labels\n", paths.size(), stats.pixels / 1e6,
+         (unsigned long long)stats.labels);
+  printf("  %7s %9s %10s %10s %9s %8s %10s %7s\n", "threads", "seconds", "images/s", "labels/s",
+         "MP/s", "speedup", "efficiency", "steals");
+  double baseline = 0;
+  for (size_t threads : counts) {
+    if (!runAudit(threads, stats)) return false;
+    if (threads == 1) baseline = stats.seconds;
+    double speedup = baseline / stats.seconds;
+    printf("  %7zu %9.2f %10.1f %10.0f %9.1f %7.2fx %9.0f%% %7llu\n", threads, stats.seconds,
+           stats.images / stats.seconds, stats.labels / stats.seconds,
+           stats.pixels / 1e6 / stats.seconds, speedup, speedup / threads * 100,
+           (unsigned long long)stats.steals);
+    fflush(stdout);
+  }
+  return true;
+}
+
+// ============== Main ==============
+
+static void addPath(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) addPath(path + "/" + name);
+  } else {
+    paths.push_back(path);
+  }
+}
+
+static void usage(const char* name) {
+  fprintf(stderr,
+          "Usage: %s [-t threads] [-s WxH (raw frames)] [-n labels per image] [-o report]\n"
+          "          [-S (scaling run)] <image|directory>...\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  size_t threads = std::thread::hardware_concurrency();
+  int expectedLabels = 0;
+  const char* reportPath = NULL;
+  bool scaling = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:s:n:o:S")) != -1) {
+    switch (opt) {
+      case 't': threads = strtoul(optarg, NULL, 10); break;
+      case 's':
+        if (sscanf(optarg, "%dx%d", &rawWidth, &rawHeight) != 2) rawWidth = rawHeight = 0;
+        break;
+      case 'n': expectedLabels = atoi(optarg); break;
+      case 'o': reportPath = optarg; break;
+      case 'S': scaling = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  for (int i = optind; i < argc; i++) addPath(argv[i]);
+  if (paths.empty() || threads == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (threads > paths.size()) threads = paths.size();
+
+  if (scaling) {
+    if (!runScaling(threads)) {
+      fprintf(stderr, "[Audit] Out of memory for quirc\n");
+      return 2;
+    }
+    if (!reportPath) return 0;
+  }
+
+  AuditStats stats;
+  if (!runAudit(threads, stats)) {
+    fprintf(stderr, "[Audit] Out of memory for quirc\n");
+    return 2;
+  }
+  markDuplicates();
+
+  FILE* out = stdout;
+  if (reportPath && !(out = fopen(reportPath, "w"))) {
+    fprintf(stderr, "[Audit] Cannot write %s: %s\n", reportPath, strerror(errno));
+    return 2;
+  }
+  size_t failures = writeReport(out, expectedLabels);
+  if (out != stdout) fclose(out);
+
+  fprintf(stderr, "[Audit] %zu images (%.1f MP), %llu labels, %zu problem(s)\n", paths.size(),
+          stats.pixels / 1e6, (unsigned long long)stats.labels, failures);
+  printThroughput(stats, threads);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * BrainSAIT OID Scanner - Host Load Test
+ *
+ * Runs the firmware's synthetic load injector against the shared scan
+ * parser on the host, using the same payload mixes and report as the
+ * device's `load` serial command.
+ *
+ * Usage: load_bench <count> [rate/s, 0=max] [json|raw|malformed|duplicate|mixed] [seed]
+ */
+
+#include <Arduino.h>
+
+#include "scan_parser.h"
+#include "load_test.h"
+
+static OIDData lastScannedOID;
+static LoadTest loadTest;
+static unsigned long formatCounts[SCAN_FORMAT_UNKNOWN + 1];
+
+/**
+ * Host stand-in for processQRContent: parse, then build the upload JSON
+ * (the device's remaining work is display, buzzer and network I/O)
+ */
+static void processQRContent(String content) {
+  ScanFormat format = parseScanPayload(content, lastScannedOID);
+  formatCounts[format]++;
+
+  if (lastScannedOID.valid) {
+    OID oid = parseOID(lastScannedOID.oid);
+    oid.name = lastScannedOID.name;
+    oid.status = lastScannedOID.status;
+    String json = toJSON(oid);
+    (void)json;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <count> [rate/s, 0=max] [json|raw|malformed|duplicate|mixed] [seed]\n",
+            argv[0]);
+    return 2;
+  }
+
+  unsigned long count = strtoul(argv[1], NULL, 10);
+  unsigned long rate = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+  unsigned long seed = argc > 4 ? strtoul(argv[4], NULL, 10) : 61026;
+  LoadMix mix = LOAD_MIX_MIXED;
+  if (argc > 3 && !parseLoadMix(argv[3], mix)) {
+    fprintf(stderr, "Unknown mix '%s'\n", argv[3]);
+    return 2;
+  }
+
+  if (!loadTest.start(count, rate, mix, seed)) {
+    fprintf(stderr, "Count must be > 0\n");
+    return 2;
+  }
+
+  while (loadTest.active()) {
+    loadTest.tick(processQRContent);
+    if (rate > 0) delayMicroseconds(100);
+  }
+
+  loadTest.printReport(Serial);
+  Serial.printf("[Load] Parsed: json=%lu json-other=%lu raw=%lu unknown=%lu\n",
+                formatCounts[SCAN_FORMAT_JSON_OID], formatCounts[SCAN_FORMAT_JSON_OTHER],
+                formatCounts[SCAN_FORMAT_RAW_OID], formatCounts[SCAN_FORMAT_UNKNOWN]);
+  return 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * BrainSAIT OID Scanner - Revoked Filter Sync Checks
+ *
+ * Feeds canned server responses to the revoked-filter sync and confirm
+ * code through a fake client. A delta must be applied only when its whole
+ * body arrived and matches its header; anything short, long or cut off
+ * leaves the filter as it was.
+ *
+ * Usage: test_revoked_filter   (exit status 1 on any failure)
+ */
+
+// Keep the timeout cases quick
+#define REVOKED_LOAD_TIMEOUT_MS    200
+#define REVOKED_CONFIRM_TIMEOUT_MS 200
+
+#include <Arduino.h>
+
+#include <string>
+
+#include "oid_utils.h"
+#include "revoked_filter.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                    \
+  do {                                                                 \
+    if (!(cond)) {                                                     \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+      failures++;                                                      \
+    }                                                                  \
+  } while (0)
+
+/**
+ * Client that serves a canned response and records what was sent
+ */
+class FakeClient : public Print {
+public:
+  FakeClient(const std::string& response, bool open) : _in(response), _open(open) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    sent.append((const char*)buf, n);
+    writes++;
+    return n;
+  }
+  using Print::write;
+
+  int available() { return (int)(_in.size() - _pos); }
+  int read() { return _pos < _in.size() ? (uint8_t)_in[_pos++] : -1; }
+  int read(uint8_t* buf, size_t n) {
+    size_t k = _in.size() - _pos < n ? _in.size() - _pos : n;
+    memcpy(buf, _in.data() + _pos, k);
+    _pos += k;
+    return (int)k;
+  }
+  bool connected() { return _open || _pos < _in.size(); }
+
+  std::string sent;
+  int writes = 0;
+
+private:
+  std::string _in;
+  size_t _pos = 0;
+  bool _open;
+};
+
+class StringPrint : public Print {
+public:
+  size_t write(uint8_t c) override { s += (char)c; return 1; }
+  using Print::write;
+  std::string s;
+};
+
+static std::string response(const char* status, const std::string& body, long contentLength) {
+  std::string head = std::string("HTTP/1.1 ") + status + "\r\n";
+  if (contentLength >= 0) head += "Content-Length: " + std::to_string(contentLength) + "\r\n";
+  return head + "\r\n" + body;
+}
+
+static std::string ok(const std::string& body) {
+  return response("200 OK", body, (long)body.size());
+}
+
+static OIDValue oid(const char* text) {
+  OIDValue value;
+  parseOIDValue(text, value);
+  return value;
+}
+
+// ============== Delta ==============
+
+static const char* DELTA_OID_1 = "1.3.6.1.4.1.61026.1.1";
+static const char* DELTA_OID_2 = "1.3.6.1.4.1.61026.1.2";
+static const std::string DELTA_BODY =
+    "generation 5 version 4\n1.3.6.1.4.1.61026.1.1\n1.3.6.1.4.1.61026.1.2\n";
+
+/**
+ * Run one delta against a filter at generation 5, version 2
+ * @param applied Whether the delta's OIDs must end up in the filter
+ */
+static void checkDelta(const char* name, const std::string& canned, bool open, int expected,
+                       bool applied) {
+  RevokedFilter filter;
+  filter.createFor(1024, 10, 5);
+  filter.setVersion(2);
+
+  FakeClient client(canned, open);
+  HttpEndpoint endpoint;
+  parseHttpUrl("http://ingest:8080/oid/revoked/delta", endpoint);
+  int result = fetchRevokedDelta(client, endpoint, "key", filter);
+
+  uint32_t version = applied ? 4 : 2;
+  uint32_t entries = applied ? 2 : 0;
+  if (result != expected || filter.version() != version || filter.entries() != entries ||
+      (applied && (!filter.mayContain(oid(DELTA_OID_1)) || !filter.mayContain(oid(DELTA_OID_2))))) {
+    printf("FAIL delta %s: result %d version %lu entries %lu, expected %d version %lu entries %lu\n",
+           name, result, (unsigned long)filter.version(), (unsigned long)filter.entries(), expected,
+           (unsigned long)version, (unsigned long)entries);
+    failures++;
+  }
+
+  // The request names what the filter already has, and goes out in one write
+  static const std::string requestLine = "GET /oid/revoked/delta?generation=5&since=2 HTTP/1.1\r\n";
+  CHECK(client.sent.compare(0, requestLine.size(), requestLine) == 0);
+  CHECK(client.writes == 1);
+}
+
+static void checkDeltas() {
+  std::string cut = DELTA_BODY.substr(0, DELTA_BODY.size() - 5);
+  std::string noNewline = DELTA_BODY.substr(0, DELTA_BODY.size() - 1);
+
+  checkDelta("complete", ok(DELTA_BODY), false, 2, true);
+  checkDelta("truncated, closed", response("200 OK", cut, (long)DELTA_BODY.size()), false,
+             HTTP_STREAM_ERROR_CLOSED, false);
+  checkDelta("truncated, open", response("200 OK", cut, (long)DELTA_BODY.size()), true,
+             HTTP_STREAM_ERROR_TIMEOUT, false);
+  checkDelta("no Content-Length", response("200 OK", DELTA_BODY, -1), false,
+             HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+  checkDelta("no final newline", ok(noNewline), false, HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+  checkDelta("extra line", ok(DELTA_BODY + "1.3.6.1.4.1.61026.1.3\n"), false,
+             HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+  checkDelta("short count",
+             ok("generation 5 version 5\n1.3.6.1.4.1.61026.1.1\n1.3.6.1.4.1.61026.1.2\n"), false,
+             HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+  checkDelta("bad OID line",
+             ok("generation 5 version 4\n1.3.6.1.4.1.61026.1.1\nnot-an-oid\n"), false,
+             HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+  checkDelta("up to date", ok("generation 5 version 2\n"), false, 0, false);
+  checkDelta("generation changed",
+             ok("generation 6 version 4\n1.3.6.1.4.1.61026.1.1\n1.3.6.1.4.1.61026.1.2\n"), false,
+             REVOKED_SYNC_RESET, false);
+  checkDelta("version went back", ok("generation 5 version 1\n"), false, REVOKED_SYNC_RESET, false);
+  checkDelta("409", response("409 Conflict", "", 0), false, REVOKED_SYNC_RESET, false);
+  checkDelta("503", response("503 Service Unavailable", "", 0), false, -503, false);
+}
+
+// ============== Snapshot ==============
+
+static void checkSnapshot(const char* name, size_t cut, int expected, bool loaded) {
+  RevokedFilter source;
+  source.createFor(4096, 10, 9);
+  source.add(oid(DELTA_OID_1));
+  source.setVersion(1);
+  StringPrint image;
+  source.save(image);
+
+  RevokedFilter filter;
+  filter.createFor(1024, 10, 5);
+  filter.setVersion(2);
+
+  std::string body = image.s.substr(0, image.s.size() - cut);
+  FakeClient client(response("200 OK", body, (long)image.s.size()), false);
+  HttpEndpoint endpoint;
+  parseHttpUrl("http://ingest:8080/oid/revoked/filter", endpoint);
+  std::mutex lock;
+  int status = fetchRevokedSnapshot(client, endpoint, "key", filter, &lock);
+
+  // A failed download keeps the old filter
+  uint32_t generation = loaded ? 9 : 5;
+  if (status != expected || filter.generation() != generation ||
+      (loaded && !filter.mayContain(oid(DELTA_OID_1)))) {
+    printf("FAIL snapshot %s: status %d generation %lu, expected %d generation %lu\n", name,
+           status, (unsigned long)filter.generation(), expected, (unsigned long)generation);
+    failures++;
+  }
+}
+
+// ============== Confirm ==============
+
+static void checkConfirm(const char* name, const std::string& canned, bool open,
+                         RevokedConfirm expected, int expectedStatus) {
+  FakeClient client(canned, open);
+  HttpEndpoint endpoint;
+  parseHttpUrl("http://ingest:8080/oid/revoked/1.3.6.1.4.1.61026.1.1", endpoint);
+  int status = 0;
+  RevokedConfirm result = confirmRevoked(client, endpoint, "key", millis(), status);
+  if (result != expected || status != expectedStatus) {
+    printf("FAIL confirm %s: result %d status %d, expected %d status %d\n", name, (int)result,
+           status, (int)expected, expectedStatus);
+    failures++;
+  }
+}
+
+int main() {
+  checkDeltas();
+
+  checkSnapshot("complete", 0, 200, true);
+  checkSnapshot("truncated", 100, HTTP_STREAM_ERROR_BAD_RESPONSE, false);
+
+  checkConfirm("revoked", response("200 OK", "", 0), false, REVOKED_CONFIRM_REVOKED, 200);
+  checkConfirm("not revoked", response("404 Not Found", "", 0), false, REVOKED_CONFIRM_LIVE, 404);
+  checkConfirm("bad API key", response("401 Unauthorized", "", 0), false,
+               REVOKED_CONFIRM_UNAVAILABLE, 401);
+  checkConfirm("server error", response("503 Service Unavailable", "", 0), false,
+               REVOKED_CONFIRM_UNAVAILABLE, 503);
+  checkConfirm("no answer", "", true, REVOKED_CONFIRM_UNAVAILABLE, HTTP_STREAM_ERROR_TIMEOUT);
+  checkConfirm("closed", "", false, REVOKED_CONFIRM_UNAVAILABLE, HTTP_STREAM_ERROR_CLOSED);
+
+  if (failures) {
+    printf("%d revoked filter check(s) failed\n", failures);
+    return 1;
+  }
+  printf("All revoked filter checks passed\n");
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * BrainSAIT OID Scanner - Scan Parser Checks
+ *
+ * Payload classification and namespace checks that the scanner and
+ * label_audit must agree on, in particular OIDs such as
+ * 1.3.6.1.4.1.610260 that share the BrainSAIT root's text but not its arcs.
+ *
+ * Usage: test_scan_parser   (exit status 1 on any failure)
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "oid_utils.h"
+#include "scan_parser.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                    \
+  do {                                                                 \
+    if (!(cond)) {                                                     \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+      failures++;                                                      \
+    }                                                                  \
+  } while (0)
+
+static void checkPayload(const char* payload, ScanFormat format, ScanNamespace ns) {
+  OIDData scan;
+  ScanFormat gotFormat = parseScanPayload(payload, scan);
+  ScanNamespace gotNs = scanNamespace(scan);
+  if (gotFormat != format || gotNs != ns) {
+    printf("FAIL %s: got %s/%s, expected %s/%s\n", payload, scanFormatName(gotFormat),
+           scanNamespaceName(gotNs), scanFormatName(format), scanNamespaceName(ns));
+    failures++;
+  }
+}
+
+int main() {
+  // ============== isBrainSAITOID ==============
+  CHECK(isBrainSAITOID("1.3.6.1.4.1.61026"));
+  CHECK(isBrainSAITOID("1.3.6.1.4.1.61026.3.2.1"));
+  CHECK(!isBrainSAITOID("1.3.6.1.4.1.610260"));
+  CHECK(!isBrainSAITOID("1.3.6.1.4.1.610260.9"));
+  CHECK(!isBrainSAITOID("1.3.6.1.4.1.6102"));
+  CHECK(!isBrainSAITOID("1.3.6.1.4.1.61026."));
+  CHECK(!isBrainSAITOID("1.3.6.1.4.1.61026x"));
+  CHECK(!isBrainSAITOID(""));
+
+  // ============== parseScanPayload + scanNamespace ==============
+  checkPayload("{\"oid\":\"1.3.6.1.4.1.61026.3.2.1\"}", SCAN_FORMAT_JSON_OID,
+               SCAN_NAMESPACE_BRAINSAIT);
+  checkPayload("{\"oid\":\"1.3.6.1.4.1.610260.9\"}", SCAN_FORMAT_JSON_OID,
+               SCAN_NAMESPACE_FOREIGN);
+  checkPayload("{\"name\":\"no oid\"}", SCAN_FORMAT_JSON_OTHER, SCAN_NAMESPACE_NONE);
+  checkPayload("1.3.6.1.4.1.61026.3.2.1", SCAN_FORMAT_RAW_OID, SCAN_NAMESPACE_BRAINSAIT);
+  checkPayload("1.3.6.1.4.1.61026", SCAN_FORMAT_RAW_OID, SCAN_NAMESPACE_BRAINSAIT);
+
+  // Whitespace around a raw OID is dropped, not stored
+  checkPayload("1.3.6.1.4.1.61026.3.2.1\n", SCAN_FORMAT_RAW_OID, SCAN_NAMESPACE_BRAINSAIT);
+  checkPayload("1.3.6.1.4.1.61026.3.2.1\r\n", SCAN_FORMAT_RAW_OID, SCAN_NAMESPACE_BRAINSAIT);
+  checkPayload(" 1.3.6.1.4.1.61026.3.2.1 ", SCAN_FORMAT_RAW_OID, SCAN_NAMESPACE_BRAINSAIT);
+  OIDData trimmed;
+  parseScanPayload("1.3.6.1.4.1.61026.3.2.1\n", trimmed);
+  CHECK(trimmed.oid == "1.3.6.1.4.1.61026.3.2.1");
+
+  // Raw payloads outside the root are not scans, whatever their text prefix
+  checkPayload("1.3.6.1.4.1.610260.9", SCAN_FORMAT_UNKNOWN, SCAN_NAMESPACE_NONE);
+  checkPayload("1.3.6.1.4.1.61026.3 trailing", SCAN_FORMAT_UNKNOWN, SCAN_NAMESPACE_NONE);
+  checkPayload("2.5.4.3", SCAN_FORMAT_UNKNOWN, SCAN_NAMESPACE_NONE);
+  checkPayload("https://example.com", SCAN_FORMAT_UNKNOWN, SCAN_NAMESPACE_NONE);
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("All scan parser checks passed\n");
+  return 0;
+}
@@ -97,9 +97,8 @@
 
 // ============== DEBUG SETTINGS ==============
 
-#define DEBUG_SERIAL        1       // Enable serial debug output
 #define DEBUG_BAUD_RATE     115200  // Serial baud rate
-#define DEBUG_VERBOSE       0       // Extra verbose logging
+// Log verbosity is a build flag, not a setting here: -DLOG_LEVEL=0..4 (log.h)
 
 // ============== OID BRANCH DEFINITIONS ==============
 
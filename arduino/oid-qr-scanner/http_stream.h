@@ -0,0 +1,343 @@
+/**
+ * BrainSAIT OID Scanner - Streaming HTTP Requests
+ *
+ * Minimal HTTP/1.1 client pieces for sending a request body straight
+ * from a serializer into the socket with chunked transfer encoding, so
+ * the payload never exists as a String in RAM.
+ */
+
+#ifndef HTTP_STREAM_H
+#define HTTP_STREAM_H
+
+#include <Arduino.h>
+
+#ifndef HTTP_CHUNK_SIZE
+#define HTTP_CHUNK_SIZE        128     // Bytes coalesced per body chunk
+#endif
+
+#ifndef HTTP_HEAD_BUFFER_SIZE
+#define HTTP_HEAD_BUFFER_SIZE  384     // Request line and headers, sent as one write
+#endif
+
+#ifndef HTTP_STREAM_TIMEOUT_MS
+#define HTTP_STREAM_TIMEOUT_MS 5000    // Wait for the response status
+#endif
+
+// Negative results from readHttpResponse()
+#define HTTP_STREAM_ERROR_TIMEOUT      -1
+#define HTTP_STREAM_ERROR_BAD_RESPONSE -2
+#define HTTP_STREAM_ERROR_CLOSED       -3
+
+/**
+ * Get a description for a negative readHttpResponse() result
+ */
+const char* httpStreamErrorName(int code) {
+  switch (code) {
+    case HTTP_STREAM_ERROR_TIMEOUT:      return "read timeout";
+    case HTTP_STREAM_ERROR_BAD_RESPONSE: return "malformed response";
+    case HTTP_STREAM_ERROR_CLOSED:       return "connection lost";
+    default:                             return "unknown error";
+  }
+}
+
+/**
+ * Parsed http:// or https:// URL
+ */
+struct HttpEndpoint {
+  bool secure;
+  String host;
+  uint16_t port;
+  String path;
+};
+
+/**
+ * Split a URL into scheme, host, port and path
+ * @return false for unsupported schemes or an empty host
+ */
+bool parseHttpUrl(const String& url, HttpEndpoint& out) {
+  int hostStart;
+  if (url.startsWith("http://")) {
+    out.secure = false;
+    out.port = 80;
+    hostStart = 7;
+  } else if (url.startsWith("https://")) {
+    out.secure = true;
+    out.port = 443;
+    hostStart = 8;
+  } else {
+    return false;
+  }
+
+  int pathStart = url.indexOf('/', hostStart);
+  String authority = pathStart < 0 ? url.substring(hostStart) : url.substring(hostStart, pathStart);
+  out.path = pathStart < 0 ? String("/") : url.substring(pathStart);
+
+  int colon = authority.indexOf(':');
+  if (colon >= 0) {
+    long port = authority.substring(colon + 1).toInt();
+    if (port <= 0 || port > 65535) return false;
+    out.port = (uint16_t)port;
+    authority = authority.substring(0, colon);
+  }
+
+  out.host = authority;
+  return out.host.length() > 0;
+}
+
+/**
+ * Write the request line and Host/Connection headers of a request
+ *
+ * Add any further headers with writeHttpHeader(), then call
+ * endHttpHeaders(). Use beginChunkedRequest() for requests with a body.
+ * Write into an HttpHeadBuffer when out is a network client.
+ */
+void beginRequest(Print& out, const char* method, const HttpEndpoint& endpoint) {
+  out.print(method);
+  out.print(' ');
+  out.print(endpoint.path);
+  out.print(" HTTP/1.1\r\nHost: ");
+  out.print(endpoint.host);
+  if (endpoint.port != (endpoint.secure ? 443 : 80)) {
+    out.print(':');
+    out.print((unsigned int)endpoint.port);
+  }
+  out.print("\r\nConnection: close\r\n");
+}
+
+/**
+ * Write the request line and fixed headers of a chunked request
+ *
+ * Add any further headers with writeHttpHeader(), then call
+ * endHttpHeaders() and stream the body through a ChunkedPrint.
+ */
+void beginChunkedRequest(Print& out, const char* method, const HttpEndpoint& endpoint,
+                         const char* contentType) {
+  beginRequest(out, method, endpoint);
+  out.print("Content-Type: ");
+  out.print(contentType);
+  out.print("\r\nTransfer-Encoding: chunked\r\n");
+}
+
+void writeHttpHeader(Print& out, const char* name, const String& value) {
+  out.print(name);
+  out.print(": ");
+  out.print(value);
+  out.print("\r\n");
+}
+
+void endHttpHeaders(Print& out) {
+  out.print("\r\n");
+}
+
+/**
+ * Print adapter that collects a request head and sends it with one write
+ *
+ * Each write to a WiFiClientSecure becomes its own TLS record, so writing
+ * the head field by field costs a record (and usually a segment) per
+ * print(). Call send() after endHttpHeaders(); a head larger than
+ * HTTP_HEAD_BUFFER_SIZE is sent in several writes.
+ */
+class HttpHeadBuffer : public Print {
+public:
+  explicit HttpHeadBuffer(Print& out) : _out(out) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t* data, size_t n) override {
+    size_t remaining = n;
+    while (remaining > 0) {
+      if (_used == HTTP_HEAD_BUFFER_SIZE) send();
+      size_t take = HTTP_HEAD_BUFFER_SIZE - _used;
+      if (take > remaining) take = remaining;
+      memcpy(_buf + _used, data, take);
+      _used += take;
+      data += take;
+      remaining -= take;
+    }
+    return n;
+  }
+  using Print::write;
+
+  void send() {
+    if (_used > 0) _out.write(_buf, _used);
+    _used = 0;
+  }
+
+private:
+  Print& _out;
+  uint8_t _buf[HTTP_HEAD_BUFFER_SIZE];
+  size_t _used = 0;
+};
+
+// Chunk size line: up to four hex digits and CRLF
+#define HTTP_CHUNK_HEAD 6
+static_assert(HTTP_CHUNK_SIZE > 0 && HTTP_CHUNK_SIZE <= 0xFFFF, "HTTP_CHUNK_SIZE must fit in 4 hex digits");
+
+/**
+ * Print adapter that frames writes as HTTP/1.1 chunks
+ *
+ * Small writes are coalesced into HTTP_CHUNK_SIZE chunks so a
+ * token-at-a-time serializer does not send a TCP segment per token. Each
+ * chunk goes out as a single write with its framing (one TLS record on
+ * WiFiClientSecure); finish() sends the last chunk together with the
+ * terminator.
+ */
+class ChunkedPrint : public Print {
+public:
+  explicit ChunkedPrint(Print& out) : _out(out) {}
+
+  size_t write(uint8_t c) override {
+    if (_used == HTTP_CHUNK_SIZE) flushChunk(false);
+    _buf[HTTP_CHUNK_HEAD + _used++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t n) override {
+    size_t remaining = n;
+    while (remaining > 0) {
+      if (_used == HTTP_CHUNK_SIZE) flushChunk(false);
+      size_t take = HTTP_CHUNK_SIZE - _used;
+      if (take > remaining) take = remaining;
+      memcpy(_buf + HTTP_CHUNK_HEAD + _used, data, take);
+      _used += take;
+      data += take;
+      remaining -= take;
+    }
+    return n;
+  }
+  using Print::write;
+
+  /**
+   * Send any buffered bytes and the terminating zero-length chunk
+   */
+  void finish() {
+    flushChunk(true);
+  }
+
+  /** Body bytes written (excluding chunk framing) */
+  size_t bodyBytes() const { return _total + _used; }
+
+private:
+  // Frame the buffered bytes in place: size line before, CRLF after
+  void flushChunk(bool last) {
+    uint8_t* start = _buf + HTTP_CHUNK_HEAD;
+    uint8_t* end = start + _used;
+    if (_used > 0) {
+      *--start = '\n';
+      *--start = '\r';
+      for (size_t n = _used; n; n >>= 4) *--start = "0123456789abcdef"[n & 0xF];
+      *end++ = '\r';
+      *end++ = '\n';
+    }
+    if (last) {
+      memcpy(end, "0\r\n\r\n", 5);
+      end += 5;
+    }
+    if (end > start) _out.write(start, end - start);
+    _total += _used;
+    _used = 0;
+  }
+
+  Print& _out;
+  uint8_t _buf[HTTP_CHUNK_HEAD + HTTP_CHUNK_SIZE + 2 + 5];  // + CRLF and the last chunk
+  size_t _used = 0;
+  size_t _total = 0;
+};
+
+/**
+ * Read one response line; CR is dropped and overlong lines are cut
+ * @param start millis() at which the overall timeout began
+ * @return Line length, or a negative HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+int readHttpLine(TClient& client, char* line, size_t size, unsigned long start,
+                 unsigned long timeoutMs) {
+  size_t len = 0;
+  while (millis() - start < timeoutMs) {
+    if (!client.available()) {
+      if (!client.connected()) break;
+      delay(1);
+      continue;
+    }
+
+    int c = client.read();
+    if (c < 0 || c == '\r') continue;
+    if (c == '\n') {
+      line[len] = '\0';
+      return (int)len;
+    }
+    if (len < size - 1) line[len++] = (char)c;
+  }
+
+  line[len] = '\0';
+  return client.connected() ? HTTP_STREAM_ERROR_TIMEOUT : HTTP_STREAM_ERROR_CLOSED;
+}
+
+/**
+ * Read a response status line and headers, leaving the body unread
+ * @param contentLength Receives Content-Length, or -1 if not sent
+ * @param start millis() at which the timeout began
+ * @return HTTP status code, or a negative HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+int readHttpHead(TClient& client, long& contentLength, unsigned long start = millis(),
+                 unsigned long timeoutMs = HTTP_STREAM_TIMEOUT_MS) {
+  char line[128];
+  int status = 0;
+  contentLength = -1;
+
+  while (true) {
+    int len = readHttpLine(client, line, sizeof(line), start, timeoutMs);
+    if (len < 0) {
+      // A server that closes without a blank line still answered
+      return status > 0 && len == HTTP_STREAM_ERROR_CLOSED ? status : len;
+    }
+
+    if (status == 0) {
+      // Status line: HTTP/1.1 201 Created
+      if (strncmp(line, "HTTP/1.", 7) != 0 || len < 12) return HTTP_STREAM_ERROR_BAD_RESPONSE;
+      status = atoi(line + 9);
+      if (status <= 0) return HTTP_STREAM_ERROR_BAD_RESPONSE;
+    } else if (len == 0) {
+      return status;
+    } else if (strncasecmp(line, "Content-Length:", 15) == 0) {
+      contentLength = atol(line + 15);
+    }
+  }
+}
+
+/**
+ * Read an HTTP response status and (a bounded prefix of) its body
+ * @param client Connected client (WiFiClient, WiFiClientSecure, ...)
+ * @param body Receives up to maxBody bytes of the body
+ * @param maxBody Body bytes to keep
+ * @param timeoutMs Time allowed for the whole response
+ * @return HTTP status code, or a negative HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+int readHttpResponse(TClient& client, String& body, size_t maxBody = 512,
+                     unsigned long timeoutMs = HTTP_STREAM_TIMEOUT_MS) {
+  unsigned long start = millis();
+  long contentLength;
+  body = "";
+
+  int status = readHttpHead(client, contentLength, start, timeoutMs);
+  if (status <= 0 || contentLength == 0 || maxBody == 0) return status;
+
+  long bodyRead = 0;
+  while (millis() - start < timeoutMs) {
+    if (!client.available()) {
+      if (!client.connected()) break;
+      delay(1);
+      continue;
+    }
+
+    int c = client.read();
+    if (c < 0) continue;
+    if (body.length() < maxBody) body += (char)c;
+    if (contentLength >= 0 && ++bodyRead >= contentLength) break;
+  }
+  return status;
+}
+
+#endif // HTTP_STREAM_H
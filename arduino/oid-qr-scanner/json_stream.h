@@ -0,0 +1,259 @@
+/**
+ * BrainSAIT OID Scanner - Streaming JSON Writer
+ *
+ * Emits JSON token by token into any Print (Serial, a network client, a
+ * chunked HTTP body) without building a document or output String first.
+ * Pretty mode matches ArduinoJson's serializeJsonPretty layout.
+ */
+
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <Arduino.h>
+
+#include "oid_utils.h"
+#include "scan_parser.h"
+
+#ifndef JSON_STREAM_MAX_DEPTH
+#define JSON_STREAM_MAX_DEPTH 8     // Deepest object/array nesting
+#endif
+
+class JsonStreamWriter {
+public:
+  JsonStreamWriter(Print& out, bool pretty = false) : _out(out), _pretty(pretty) {}
+
+  void beginObject() { open('{'); }
+  void endObject() { close('}'); }
+  void beginArray() { open('['); }
+  void endArray() { close(']'); }
+
+  /**
+   * Write an object key; the next value call completes the member
+   */
+  void key(const char* name) {
+    separate();
+    writeString(name, strlen(name));
+    _bytes += _out.write(_pretty ? ": " : ":");
+    _afterKey = true;
+  }
+
+  void value(const char* s) {
+    separate();
+    if (s) writeString(s, strlen(s));
+    else _bytes += _out.write("null");
+  }
+  void value(const String& s) { separate(); writeString(s.c_str(), s.length()); }
+  void value(bool b) { separate(); _bytes += _out.write(b ? "true" : "false"); }
+  void value(int v) { value((long)v); }
+  void value(unsigned int v) { value((unsigned long)v); }
+  void value(long v) {
+    separate();
+    if (v < 0) {
+      _bytes += _out.write((uint8_t)'-');
+      writeDigits(0UL - (unsigned long)v);
+    } else {
+      writeDigits((unsigned long)v);
+    }
+  }
+  void value(unsigned long v) { separate(); writeDigits(v); }
+
+  /**
+   * Write one string value from two parts (e.g. "urn:oid:" + oid)
+   */
+  void joinedValue(const char* prefix, const String& s) {
+    separate();
+    _bytes += _out.write((uint8_t)'"');
+    writeEscaped(prefix, strlen(prefix));
+    writeEscaped(s.c_str(), s.length());
+    _bytes += _out.write((uint8_t)'"');
+  }
+
+  /**
+   * Write an already-serialized JSON value verbatim
+   */
+  void rawValue(const char* json, size_t n) {
+    separate();
+    _bytes += _out.write((const uint8_t*)json, n);
+  }
+
+  template <typename T>
+  void member(const char* name, const T& v) {
+    key(name);
+    value(v);
+  }
+
+  /** Bytes emitted so far */
+  size_t bytesWritten() const { return _bytes; }
+
+private:
+  void open(char c) {
+    separate();
+    _bytes += _out.write((uint8_t)c);
+    if (_depth < JSON_STREAM_MAX_DEPTH) _empty[_depth] = true;
+    _depth++;
+  }
+
+  void close(char c) {
+    if (_depth == 0) return;
+    _depth--;
+    bool empty = _depth < JSON_STREAM_MAX_DEPTH ? _empty[_depth] : false;
+    if (_pretty && !empty) newline();
+    _bytes += _out.write((uint8_t)c);
+  }
+
+  // Comma/newline/indent before a value or key
+  void separate() {
+    if (_afterKey) {
+      _afterKey = false;
+      return;
+    }
+    if (_depth == 0) return;
+    uint8_t level = _depth - 1;
+    if (level < JSON_STREAM_MAX_DEPTH) {
+      if (!_empty[level]) _bytes += _out.write((uint8_t)',');
+      _empty[level] = false;
+    }
+    if (_pretty) newline();
+  }
+
+  void newline() {
+    _bytes += _out.write("\r\n");
+    for (uint8_t i = 0; i < _depth; i++) _bytes += _out.write("  ");
+  }
+
+  // Hand-rolled to keep snprintf's stack cost out of the hot path
+  void writeDigits(unsigned long v) {
+    char buf[20];
+    char* p = buf + sizeof(buf);
+    do {
+      *--p = (char)('0' + v % 10);
+      v /= 10;
+    } while (v);
+    _bytes += _out.write((const uint8_t*)p, buf + sizeof(buf) - p);
+  }
+
+  void writeString(const char* s, size_t len) {
+    _bytes += _out.write((uint8_t)'"');
+    writeEscaped(s, len);
+    _bytes += _out.write((uint8_t)'"');
+  }
+
+  void writeEscaped(const char* s, size_t len) {
+    // Copy unescaped runs in one write
+    size_t run = 0;
+    for (size_t i = 0; i < len; i++) {
+      unsigned char c = (unsigned char)s[i];
+      const char* esc = NULL;
+      char hex[7] = { '\\', 'u', '0', '0', 0, 0, 0 };
+      switch (c) {
+        case '"':  esc = "\\\""; break;
+        case '\\': esc = "\\\\"; break;
+        case '\b': esc = "\\b"; break;
+        case '\f': esc = "\\f"; break;
+        case '\n': esc = "\\n"; break;
+        case '\r': esc = "\\r"; break;
+        case '\t': esc = "\\t"; break;
+        default:
+          if (c < 0x20) {
+            hex[4] = "0123456789abcdef"[c >> 4];
+            hex[5] = "0123456789abcdef"[c & 0xF];
+            esc = hex;
+          }
+          break;
+      }
+      if (!esc) continue;
+
+      if (i > run) _bytes += _out.write((const uint8_t*)s + run, i - run);
+      _bytes += _out.write(esc);
+      run = i + 1;
+    }
+    if (len > run) _bytes += _out.write((const uint8_t*)s + run, len - run);
+  }
+
+  Print& _out;
+  bool _pretty;
+  bool _afterKey = false;
+  uint8_t _depth = 0;
+  bool _empty[JSON_STREAM_MAX_DEPTH] = {};
+  size_t _bytes = 0;
+};
+
+/**
+ * Print sink that only counts bytes (Content-Length, benchmarks)
+ */
+class CountingPrint : public Print {
+public:
+  size_t write(uint8_t) override { _count++; return 1; }
+  size_t write(const uint8_t*, size_t n) override { _count += n; return n; }
+  using Print::write;
+
+  size_t count() const { return _count; }
+
+private:
+  size_t _count = 0;
+};
+
+/**
+ * Stream the JSON representation of an OID (same fields as toJSON)
+ * @param out Destination
+ * @param oid Parsed OID structure
+ * @param pretty Indent like serializeJsonPretty
+ * @return Bytes written
+ */
+size_t writeOIDJson(Print& out, const OID& oid, bool pretty = true) {
+  JsonStreamWriter json(out, pretty);
+
+  json.beginObject();
+  json.member("oid", oid.fullPath);
+  json.key("urn");
+  json.joinedValue("urn:oid:", oid.fullPath);
+  json.member("depth", oid.depth);
+  json.member("isBrainSAIT", oid.isBrainSAIT);
+
+  if (oid.isBrainSAIT) {
+    json.member("pen", 61026);
+    json.member("branch", branchName(oid));
+    json.member("branchType", oid.branchType);
+  }
+
+  if (oid.name.length() > 0) json.member("name", oid.name);
+  if (oid.description.length() > 0) json.member("description", oid.description);
+  if (oid.status.length() > 0) json.member("status", oid.status);
+  if (oid.nodeType.length() > 0) json.member("nodeType", oid.nodeType);
+
+  json.key("arcs");
+  json.beginArray();
+  for (int i = 0; i < oid.depth; i++) {
+    json.value(oid.components[i]);
+  }
+  json.endArray();
+
+  json.endObject();
+  return json.bytesWritten();
+}
+
+/**
+ * Stream the scan upload payload sent to the BrainSAIT API
+ * @param out Destination (network client, chunked body, Serial)
+ * @param data Scan data
+ * @param scannedAt Device uptime at scan (ms)
+ * @param deviceIP Device IP address
+ * @param wifiSSID Connected network
+ * @param pretty Indent for human reading
+ * @return Bytes written
+ */
+size_t writeScanJson(Print& out, const OIDData& data, unsigned long scannedAt,
+                     const String& deviceIP, const char* wifiSSID, bool pretty = false) {
+  JsonStreamWriter json(out, pretty);
+
+  json.beginObject();
+  json.member("oid", data.oid);
+  json.member("name", data.name);
+  json.member("scannedAt", scannedAt);
+  json.member("deviceIP", deviceIP);
+  json.member("wifiSSID", wifiSSID);
+  json.endObject();
+  return json.bytesWritten();
+}
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,352 @@
+/**
+ * BrainSAIT OID Scanner - Synthetic Load Injection
+ *
+ * Feeds generated QR payloads straight into the scan pipeline at a
+ * chosen rate and reports throughput and per-scan latency, so devices
+ * and host builds can be load-tested without printed labels.
+ */
+
+#ifndef LOAD_TEST_H
+#define LOAD_TEST_H
+
+#include <Arduino.h>
+
+#include "oid_utils.h"
+
+#ifndef LOAD_PAYLOAD_MAX
+#define LOAD_PAYLOAD_MAX    192     // Largest generated payload
+#endif
+
+#ifndef LOAD_TICK_BUDGET_US
+#define LOAD_TICK_BUDGET_US 20000   // Max time spent injecting per tick()
+#endif
+
+/**
+ * Payload mixes the generator can produce
+ */
+enum LoadMix {
+  LOAD_MIX_JSON,        // BrainSAIT platform JSON
+  LOAD_MIX_RAW,         // Bare OID strings
+  LOAD_MIX_MALFORMED,   // Truncated JSON and garbage
+  LOAD_MIX_DUPLICATE,   // The same label scanned repeatedly
+  LOAD_MIX_MIXED        // 70% JSON, 15% raw, 10% duplicate, 5% malformed
+};
+
+enum LoadPayloadKind {
+  LOAD_KIND_JSON,
+  LOAD_KIND_RAW,
+  LOAD_KIND_MALFORMED,
+  LOAD_KIND_DUPLICATE,
+  LOAD_KIND_COUNT
+};
+
+/**
+ * Get the command-line name of a payload mix
+ */
+const char* loadMixName(LoadMix mix) {
+  switch (mix) {
+    case LOAD_MIX_JSON:      return "json";
+    case LOAD_MIX_RAW:       return "raw";
+    case LOAD_MIX_MALFORMED: return "malformed";
+    case LOAD_MIX_DUPLICATE: return "duplicate";
+    default:                 return "mixed";
+  }
+}
+
+/**
+ * Look up a payload mix by name
+ * @return false if the name is not recognised
+ */
+bool parseLoadMix(const char* name, LoadMix& mix) {
+  static const LoadMix mixes[] = {
+    LOAD_MIX_JSON, LOAD_MIX_RAW, LOAD_MIX_MALFORMED, LOAD_MIX_DUPLICATE, LOAD_MIX_MIXED
+  };
+  for (LoadMix m : mixes) {
+    if (strcmp(name, loadMixName(m)) == 0) {
+      mix = m;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Fixed-size latency histogram
+ *
+ * Exact below 16us, then 8 sub-buckets per power of two (~12% error).
+ */
+class LatencyHistogram {
+public:
+  static const int BUCKETS = 16 + 28 * 8;
+
+  void reset() {
+    memset(_buckets, 0, sizeof(_buckets));
+    _count = 0;
+    _sum = 0;
+    _min = UINT32_MAX;
+    _max = 0;
+  }
+
+  void record(uint32_t us) {
+    _buckets[bucketFor(us)]++;
+    _count++;
+    _sum += us;
+    if (us < _min) _min = us;
+    if (us > _max) _max = us;
+  }
+
+  /** Add another histogram's samples to this one */
+  void merge(const LatencyHistogram& other) {
+    for (int b = 0; b < BUCKETS; b++) _buckets[b] += other._buckets[b];
+    _count += other._count;
+    _sum += other._sum;
+    if (other._count && other._min < _min) _min = other._min;
+    if (other._max > _max) _max = other._max;
+  }
+
+  uint32_t count() const { return _count; }
+  uint32_t minUs() const { return _count ? _min : 0; }
+  uint32_t maxUs() const { return _max; }
+  uint32_t meanUs() const { return _count ? (uint32_t)(_sum / _count) : 0; }
+
+  /**
+   * Upper bound of the bucket holding the given percentile
+   * @param pct Percentile (0-100)
+   */
+  uint32_t percentile(float pct) const {
+    if (_count == 0) return 0;
+    uint64_t rank = (uint64_t)((pct / 100.0f) * _count + 0.5f);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+      seen += _buckets[b];
+      if (seen >= rank) {
+        uint32_t upper = b + 1 < BUCKETS ? lowerBound(b + 1) - 1 : UINT32_MAX;
+        return upper < _max ? upper : _max;
+      }
+    }
+    return _max;
+  }
+
+private:
+  static int bucketFor(uint32_t us) {
+    if (us < 16) return us;
+    int msb = 31 - __builtin_clz(us);
+    int sub = (us >> (msb - 3)) & 7;
+    return 16 + (msb - 4) * 8 + sub;
+  }
+
+  static uint32_t lowerBound(int bucket) {
+    if (bucket < 16) return bucket;
+    int msb = (bucket - 16) / 8 + 4;
+    int sub = (bucket - 16) % 8;
+    return (uint32_t)(8 + sub) << (msb - 3);
+  }
+
+  uint32_t _buckets[BUCKETS] = {};
+  uint32_t _count = 0;
+  uint64_t _sum = 0;
+  uint32_t _min = UINT32_MAX;
+  uint32_t _max = 0;
+};
+
+/**
+ * Rate-paced synthetic payload injector
+ *
+ * Call tick() from the main loop; it injects every payload that is due
+ * (bounded by LOAD_TICK_BUDGET_US) and returns so scanning and the
+ * console keep running between bursts.
+ */
+class LoadTest {
+public:
+  typedef void (*ScanHandler)(String content);
+
+  /**
+   * Begin a run
+   * @param count Number of payloads to inject
+   * @param ratePerSec Target rate, 0 for as fast as possible
+   * @param mix Payload mix
+   * @param seed Generator seed (runs are reproducible)
+   */
+  bool start(uint32_t count, uint32_t ratePerSec, LoadMix mix, uint32_t seed = 61026) {
+    if (count == 0) return false;
+    _count = count;
+    _rate = ratePerSec;
+    _mix = mix;
+    _rng = seed ? seed : 1;
+    _sent = 0;
+    _last[0] = '\0';
+    memset(_kinds, 0, sizeof(_kinds));
+    _latency.reset();
+    _aborted = false;
+    _active = true;
+    _elapsedUs = 0;
+    _lastUs = micros();
+    return true;
+  }
+
+  /** Abort the current run; the report covers what was injected */
+  void stop() {
+    if (!_active) return;
+    advanceClock();
+    _active = false;
+    _aborted = true;
+  }
+
+  bool active() const { return _active; }
+  uint32_t sent() const { return _sent; }
+  const LatencyHistogram& latency() const { return _latency; }
+
+  /**
+   * Inject all payloads that are due
+   * @param handler Scan pipeline entry point for synthetic payloads
+   */
+  void tick(ScanHandler handler) {
+    if (!_active) return;
+
+    unsigned long tickStart = micros();
+    while (_sent < _count) {
+      advanceClock();
+      if (_rate > 0 && _elapsedUs * _rate < (uint64_t)_sent * 1000000ULL) {
+        break;  // Next payload not due yet
+      }
+      if (_lastUs - tickStart >= LOAD_TICK_BUDGET_US) break;
+
+      char payload[LOAD_PAYLOAD_MAX];
+      LoadPayloadKind kind = nextPayload(payload, sizeof(payload));
+      _kinds[kind]++;
+
+      unsigned long begin = micros();
+      handler(String(payload));
+      _latency.record(micros() - begin);
+      _sent++;
+    }
+
+    if (_sent >= _count) {
+      advanceClock();
+      _active = false;
+    }
+  }
+
+  /**
+   * Print throughput and latency for the last run
+   */
+  void printReport(Print& out) const {
+    uint64_t elapsedUs = _elapsedUs + (_active ? micros() - _lastUs : 0);
+    double seconds = elapsedUs / 1000000.0;
+    double throughput = seconds > 0 ? _sent / seconds : 0;
+
+    out.printf("\n[Load] %s: %lu/%lu payloads (%s) in %.3f s\n",
+               _aborted ? "Aborted" : (_active ? "Running" : "Complete"),
+               (unsigned long)_sent, (unsigned long)_count, loadMixName(_mix), seconds);
+    if (_rate > 0) {
+      out.printf("[Load] Throughput: %.1f scans/s (target %lu/s)\n",
+                 throughput, (unsigned long)_rate);
+    } else {
+      out.printf("[Load] Throughput: %.1f scans/s (unpaced)\n", throughput);
+    }
+    out.printf("[Load] Payloads: json=%lu raw=%lu malformed=%lu duplicate=%lu\n",
+               (unsigned long)_kinds[LOAD_KIND_JSON], (unsigned long)_kinds[LOAD_KIND_RAW],
+               (unsigned long)_kinds[LOAD_KIND_MALFORMED], (unsigned long)_kinds[LOAD_KIND_DUPLICATE]);
+    out.printf("[Load] Latency (us): min=%lu avg=%lu p50=%lu p90=%lu p99=%lu max=%lu\n",
+               (unsigned long)_latency.minUs(), (unsigned long)_latency.meanUs(),
+               (unsigned long)_latency.percentile(50), (unsigned long)_latency.percentile(90),
+               (unsigned long)_latency.percentile(99), (unsigned long)_latency.maxUs());
+  }
+
+private:
+  // micros() wraps every ~71.6 min; deltas between ticks never do
+  void advanceClock() {
+    unsigned long now = micros();
+    _elapsedUs += now - _lastUs;
+    _lastUs = now;
+  }
+
+  uint32_t nextRandom() {
+    // xorshift32 - cheap and reproducible across device and host
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+  }
+
+  LoadPayloadKind pickKind() {
+    switch (_mix) {
+      case LOAD_MIX_JSON:      return LOAD_KIND_JSON;
+      case LOAD_MIX_RAW:       return LOAD_KIND_RAW;
+      case LOAD_MIX_MALFORMED: return LOAD_KIND_MALFORMED;
+      case LOAD_MIX_DUPLICATE: return LOAD_KIND_DUPLICATE;
+      default: {
+        uint32_t roll = nextRandom() % 100;
+        if (roll < 70) return LOAD_KIND_JSON;
+        if (roll < 85) return LOAD_KIND_RAW;
+        if (roll < 95) return LOAD_KIND_DUPLICATE;
+        return LOAD_KIND_MALFORMED;
+      }
+    }
+  }
+
+  LoadPayloadKind nextPayload(char* buf, size_t size) {
+    LoadPayloadKind kind = pickKind();
+
+    // Nothing to repeat yet: the first duplicate is a fresh JSON label
+    if (kind == LOAD_KIND_DUPLICATE && _last[0] != '\0') {
+      strncpy(buf, _last, size - 1);
+      buf[size - 1] = '\0';
+      return kind;
+    }
+
+    // Spread scans across the four BrainSAIT branches
+    unsigned branch = 1 + nextRandom() % 4;
+    unsigned sub = 1 + nextRandom() % 8;
+    unsigned leaf = 1 + nextRandom() % 64;
+
+    switch (kind) {
+      case LOAD_KIND_RAW:
+        snprintf(buf, size, BRAINSAIT_ROOT ".%u.%u.%u", branch, sub, leaf);
+        break;
+
+      case LOAD_KIND_MALFORMED:
+        switch (nextRandom() % 3) {
+          case 0:  // Truncated mid-string
+            snprintf(buf, size, "{\"oid\":\"" BRAINSAIT_ROOT ".%u.%u", branch, sub);
+            break;
+          case 1:  // Not JSON, not an OID
+            snprintf(buf, size, "LOADTEST-%lu", (unsigned long)_sent);
+            break;
+          default:  // Valid JSON without an OID
+            snprintf(buf, size, "{\"asset\":%lu,\"status\":\"active\"}", (unsigned long)_sent);
+            break;
+        }
+        break;
+
+      default:
+        snprintf(buf, size,
+                 "{\"oid\":\"" BRAINSAIT_ROOT ".%u.%u.%u\",\"name\":\"Load Asset %lu\","
+                 "\"nodeType\":\"leaf\",\"status\":\"active\"}",
+                 branch, sub, leaf, (unsigned long)_sent);
+        break;
+    }
+
+    if (kind != LOAD_KIND_MALFORMED) {
+      strncpy(_last, buf, sizeof(_last) - 1);
+      _last[sizeof(_last) - 1] = '\0';
+    }
+    return kind == LOAD_KIND_DUPLICATE ? LOAD_KIND_JSON : kind;
+  }
+
+  uint32_t _count = 0;
+  uint32_t _rate = 0;
+  uint32_t _sent = 0;
+  uint32_t _rng = 1;
+  LoadMix _mix = LOAD_MIX_MIXED;
+  bool _active = false;
+  bool _aborted = false;
+  uint64_t _elapsedUs = 0;     // Run time so far, accumulated from micros() deltas
+  unsigned long _lastUs = 0;
+  uint32_t _kinds[LOAD_KIND_COUNT] = {};
+  char _last[LOAD_PAYLOAD_MAX] = {};
+  LatencyHistogram _latency;
+};
+
+#endif // LOAD_TEST_H
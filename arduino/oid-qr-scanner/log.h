@@ -0,0 +1,268 @@
+/**
+ * BrainSAIT OID Scanner - Buffered Logging
+ *
+ * Leveled log macros that compile out entirely below LOG_LEVEL. Enabled
+ * messages are formatted into fixed slots of a lock-free ring and written
+ * to the UART by a low-priority task, so the scan loop never waits on
+ * the serial port. Messages that do not fit are counted and reported.
+ * Direct console output (command replies) goes through logConsole, which
+ * writes whole lines under the same lock, so the two never interleave.
+ *
+ *   LOG_I("API", "Server error: %d", code);   // -> "[API] Server error: 500"
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <mutex>
+
+// ============== Levels ==============
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+// The only switch: set with a build flag, e.g. -DLOG_LEVEL=4 in platformio.ini
+#ifndef LOG_LEVEL
+#define LOG_LEVEL           LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_RING_SLOTS
+  #if LOG_LEVEL == LOG_LEVEL_NONE
+    #define LOG_RING_SLOTS  1       // Nothing is ever queued
+  #else
+    #define LOG_RING_SLOTS  32      // Queued messages (power of two)
+  #endif
+#endif
+
+#ifndef LOG_LINE_MAX
+#define LOG_LINE_MAX        160     // Longest message, longer ones are cut (a 44-column
+                                    // box is 132 bytes: its characters are 3-byte UTF-8)
+#endif
+
+#ifndef LOG_DRAIN_INTERVAL_MS
+#define LOG_DRAIN_INTERVAL_MS 10    // Drain task poll period
+#endif
+
+#ifndef LOG_TASK_PRIORITY
+#define LOG_TASK_PRIORITY   1       // Below WiFi/lwIP, same as loop()
+#endif
+
+#ifndef LOG_TASK_CORE
+#define LOG_TASK_CORE       0       // loop() runs on core 1
+#endif
+
+#if (LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) != 0
+#error "LOG_RING_SLOTS must be a power of two"
+#endif
+
+// ============== Macros ==============
+
+#define LOG_DISCARD(...) do {} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define LOG_E(tag, fmt, ...) logWrite("[" tag "] " fmt, ##__VA_ARGS__)
+#else
+  #define LOG_E(tag, fmt, ...) LOG_DISCARD()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+  #define LOG_W(tag, fmt, ...) logWrite("[" tag "] " fmt, ##__VA_ARGS__)
+#else
+  #define LOG_W(tag, fmt, ...) LOG_DISCARD()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  #define LOG_I(tag, fmt, ...) logWrite("[" tag "] " fmt, ##__VA_ARGS__)
+#else
+  #define LOG_I(tag, fmt, ...) LOG_DISCARD()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define LOG_D(tag, fmt, ...) logWrite("[" tag "] " fmt, ##__VA_ARGS__)
+#else
+  #define LOG_D(tag, fmt, ...) LOG_DISCARD()
+#endif
+
+// ============== Ring ==============
+
+/**
+ * Bounded multi-producer, single-consumer message ring
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue): producers
+ * claim a slot with one CAS on the head and format straight into it, the
+ * consumer releases it by advancing the sequence. A full ring drops the
+ * message and bumps a counter instead of blocking.
+ */
+class LogRing {
+public:
+  LogRing() {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; i++) {
+      _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool push(const char* fmt, va_list args) {
+    uint32_t pos = _head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &_slots[pos & (LOG_RING_SLOTS - 1)];
+      int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = _head.load(std::memory_order_relaxed);
+      }
+    }
+
+    int n = vsnprintf(slot->text, LOG_LINE_MAX, fmt, args);
+    slot->length = n < 0 ? 0 : (n >= LOG_LINE_MAX ? LOG_LINE_MAX - 1 : (uint16_t)n);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Write queued messages to out (single consumer only)
+   * @return Messages written
+   */
+  size_t drain(Print& out, size_t maxMessages = LOG_RING_SLOTS) {
+    size_t written = 0;
+
+    uint32_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _droppedReported) {
+      out.printf("[Log] %lu message(s) dropped\r\n", (unsigned long)(dropped - _droppedReported));
+      _droppedReported = dropped;
+    }
+
+    while (written < maxMessages) {
+      Slot* slot = &_slots[_tail & (LOG_RING_SLOTS - 1)];
+      if (slot->seq.load(std::memory_order_acquire) != _tail + 1) break;  // Empty
+
+      out.write((const uint8_t*)slot->text, slot->length);
+      out.write((const uint8_t*)"\r\n", 2);
+
+      slot->seq.store(_tail + LOG_RING_SLOTS, std::memory_order_release);
+      _tail++;
+      _written++;
+      written++;
+    }
+    return written;
+  }
+
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+  uint32_t written() const { return _written; }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    uint16_t length;
+    char text[LOG_LINE_MAX];
+  };
+
+  Slot _slots[LOG_RING_SLOTS];
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _dropped{0};
+  uint32_t _tail = 0;              // Consumer only
+  uint32_t _droppedReported = 0;   // Consumer only
+  uint32_t _written = 0;           // Consumer only
+};
+
+LogRing logRing;
+Print* logOutput = NULL;
+std::mutex logOutputLock;   // Held per line by the drain task and logConsole
+
+/**
+ * Queue a formatted message (use the LOG_* macros)
+ */
+void logWrite(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+void logWrite(const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  logRing.push(fmt, args);
+  va_end(args);
+}
+
+/**
+ * Write everything queued so far to the log output
+ * @return Messages written
+ */
+size_t logFlush() {
+  if (!logOutput) return 0;
+  size_t total = 0;
+  while (true) {
+    // One message per lock, so a console reply waits for at most one line
+    std::lock_guard<std::mutex> lock(logOutputLock);
+    size_t n = logRing.drain(*logOutput, 1);
+    if (n == 0) break;
+    total += n;
+  }
+  return total;
+}
+
+/**
+ * Line-buffered console output for command replies
+ *
+ * Each complete line is written to the log output under logOutputLock,
+ * so replies printed from loop() and messages from the drain task stay
+ * whole. Single writer (the loop task).
+ */
+class LogConsole : public Print {
+public:
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t* data, size_t n) override {
+    for (size_t i = 0; i < n; i++) {
+      _line[_length++] = data[i];
+      if (data[i] == '\n' || _length == sizeof(_line)) flushLine();
+    }
+    return n;
+  }
+  using Print::write;
+
+  void flush() override { flushLine(); }
+
+private:
+  void flushLine() {
+    if (_length > 0 && logOutput) {
+      std::lock_guard<std::mutex> lock(logOutputLock);
+      logOutput->write(_line, _length);
+    }
+    _length = 0;
+  }
+
+  uint8_t _line[LOG_LINE_MAX];
+  size_t _length = 0;
+};
+
+LogConsole logConsole;
+
+#if defined(ARDUINO_ARCH_ESP32)
+void logDrainTask(void*) {
+  while (true) {
+    logFlush();
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+  }
+}
+#endif
+
+/**
+ * Route log output and start the drain task
+ *
+ * On the host there is no task; call logFlush() to drain.
+ */
+void logBegin(Print& out) {
+  logOutput = &out;
+#if defined(ARDUINO_ARCH_ESP32) && LOG_LEVEL > LOG_LEVEL_NONE
+  xTaskCreatePinnedToCore(logDrainTask, "log", 3072, NULL, LOG_TASK_PRIORITY, NULL, LOG_TASK_CORE);
+#endif
+}
+
+#endif // LOG_H
@@ -11,17 +11,23 @@
  */
 
 #include <WiFi.h>
-#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include <EEPROM.h>
+#include <LittleFS.h>
+
+#include <memory>
+#include <mutex>
 
 // ============== CONFIGURATION ==============
 // Choose your hardware setup
+#ifndef USE_ESP32_CAM
 #define USE_ESP32_CAM  1  // Set to 1 for ESP32-CAM, 0 for GM65 module
+#endif
 
 #if USE_ESP32_CAM
   #include "esp_camera.h"
-  #include "quirc.h"  // QR code decoder library
+  #include "qr_decode.h"  // quirc QR code decoder
 
   // ESP32-CAM (AI-Thinker) pin definitions
   #define PWDN_GPIO_NUM     32
@@ -48,6 +54,15 @@
   HardwareSerial GM65Serial(2);
 #endif
 
+#include "log.h"
+#include "scan_parser.h"
+#include "serial_console.h"
+#include "load_test.h"
+#include "oid_set.h"
+#include "json_stream.h"
+#include "http_stream.h"
+#include "revoked_filter.h"
+
 // WiFi Configuration
 const char* WIFI_SSID = "YOUR_WIFI_SSID";
 const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
@@ -64,20 +79,44 @@ const int BRAINSAIT_PEN = 61026;
 #define STATUS_LED_PIN    33
 #define BUZZER_PIN        12
 
-// ============== GLOBAL VARIABLES ==============
-struct OIDData {
-  String oid;
-  String name;
-  String description;
-  String nodeType;
-  String status;
-  String timestamp;
-  bool valid;
-};
+// Session scan index (distinct OIDs kept for subtree queries)
+#define SCAN_INDEX_MAX    256
 
+// Revoked OID filter sync (background task, off the scan loop)
+#define REVOKED_SYNC_INTERVAL_MS  (15UL * 60 * 1000)
+#define REVOKED_FP_CACHE_MAX      32   // Filter hits confirmed not revoked
+#define REVOKED_TASK_STACK        8192 // Room for a TLS handshake
+#define REVOKED_TASK_CORE         0    // With the WiFi stack, away from loop()
+
+// ============== GLOBAL VARIABLES ==============
 OIDData lastScannedOID;
 bool wifiConnected = false;
 
+SerialConsole console(Serial);
+LoadTest loadTest;
+OIDMap<uint16_t> scanIndex;  // Scan count per OID this session
+LatencyHistogram loopTime;   // Scan loop duration, excluding the idle delay
+
+// Written only by the sync task, under revokedLock; loop() reads under it too
+RevokedFilter revokedFilter;
+OIDSet revokedFalsePositives;   // Cleared on every sync
+std::mutex revokedLock;
+TaskHandle_t revokedSyncTaskHandle = NULL;
+unsigned long lastRevokedSync = 0;
+uint32_t revokedConfirmed = 0;
+
+/**
+ * Connection state for one API request
+ *
+ * The TLS client is only created for https endpoints: WiFiClientSecure
+ * allocates its SSL context in the constructor.
+ */
+struct APIConnection {
+  HttpEndpoint endpoint;
+  WiFiClient plain;
+  std::unique_ptr<WiFiClientSecure> secure;
+};
+
 #if USE_ESP32_CAM
   struct quirc *qr = NULL;
   camera_fb_t *fb = NULL;
@@ -86,10 +125,11 @@ bool wifiConnected = false;
 // ============== SETUP ==============
 void setup() {
   Serial.begin(115200);
-  Serial.println("\n========================================");
-  Serial.println("  BrainSAIT OID QR Scanner v1.0");
-  Serial.println("  PEN: 61026 | Root: 1.3.6.1.4.1.61026");
-  Serial.println("========================================\n");
+  logBegin(Serial);
+  logConsole.println("\n========================================");
+  logConsole.println("  BrainSAIT OID QR Scanner v1.0");
+  logConsole.println("  PEN: 61026 | Root: 1.3.6.1.4.1.61026");
+  logConsole.println("========================================\n");
 
   // Initialize pins
   pinMode(STATUS_LED_PIN, OUTPUT);
@@ -101,8 +141,13 @@ void setup() {
   // Initialize EEPROM for storing scan history
   EEPROM.begin(512);
 
-  // Connect to WiFi
+  // Revoked OID filter from flash, then catch up online
+  initRevokedFilter();
+
+  // Connect to WiFi, then keep the revoked filter in sync in the background
   connectWiFi();
+  xTaskCreatePinnedToCore(revokedSyncTask, "revoked", REVOKED_TASK_STACK, NULL, 1,
+                          &revokedSyncTaskHandle, REVOKED_TASK_CORE);
 
   // Initialize QR scanner
   #if USE_ESP32_CAM
@@ -114,48 +159,56 @@ void setup() {
 
   // Ready signal
   successBeep();
-  Serial.println("[READY] OID Scanner initialized. Waiting for QR codes...\n");
+  LOG_I("READY", "OID Scanner initialized. Waiting for QR codes...");
 }
 
 // ============== MAIN LOOP ==============
 void loop() {
+  unsigned long loopStart = micros();
+
   #if USE_ESP32_CAM
     scanQRWithCamera();
   #else
     scanQRWithGM65();
   #endif
 
-  // Handle serial commands
-  if (Serial.available()) {
-    handleSerialCommand();
+  // Handle serial commands without blocking the scan loop
+  if (console.poll()) {
+    handleSerialCommand(console.line());
   }
 
-  delay(100);
+  // Inject any synthetic load payloads that are due
+  if (loadTest.active()) {
+    loadTest.tick(processSyntheticContent);
+    if (!loadTest.active()) {
+      loadTest.printReport(logConsole);
+      printLoopTime();
+    }
+  }
+
+  loopTime.record(micros() - loopStart);
+  delay(loadTest.active() ? 1 : 100);
 }
 
 // ============== WiFi Functions ==============
 void connectWiFi() {
-  Serial.print("[WiFi] Connecting to ");
-  Serial.println(WIFI_SSID);
+  LOG_I("WiFi", "Connecting to %s", WIFI_SSID);
 
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
   int attempts = 0;
   while (WiFi.status() != WL_CONNECTED && attempts < 30) {
     delay(500);
-    Serial.print(".");
     attempts++;
     digitalWrite(STATUS_LED_PIN, !digitalRead(STATUS_LED_PIN));
   }
 
   if (WiFi.status() == WL_CONNECTED) {
     wifiConnected = true;
-    Serial.println("\n[WiFi] Connected!");
-    Serial.print("[WiFi] IP: ");
-    Serial.println(WiFi.localIP());
+    LOG_I("WiFi", "Connected! IP: %s", WiFi.localIP().toString().c_str());
     digitalWrite(STATUS_LED_PIN, HIGH);
   } else {
-    Serial.println("\n[WiFi] Connection failed - running in offline mode");
+    LOG_W("WiFi", "Connection failed - running in offline mode");
     wifiConnected = false;
   }
 }
@@ -163,7 +216,7 @@ void connectWiFi() {
 // ============== Camera Functions (ESP32-CAM) ==============
 #if USE_ESP32_CAM
 void initCamera() {
-  Serial.println("[Camera] Initializing ESP32-CAM...");
+  LOG_I("Camera", "Initializing ESP32-CAM...");
 
   camera_config_t config;
   config.ledc_channel = LEDC_CHANNEL_0;
@@ -193,28 +246,28 @@ void initCamera() {
 
   esp_err_t err = esp_camera_init(&config);
   if (err != ESP_OK) {
-    Serial.printf("[Camera] Init failed with error 0x%x\n", err);
+    LOG_E("Camera", "Init failed with error 0x%x", err);
     errorBeep();
     return;
   }
 
-  Serial.println("[Camera] Initialized successfully");
+  LOG_I("Camera", "Initialized successfully");
 }
 
 void initQRDecoder() {
-  Serial.println("[QR] Initializing quirc decoder...");
+  LOG_I("QR", "Initializing quirc decoder...");
   qr = quirc_new();
   if (!qr) {
-    Serial.println("[QR] Failed to allocate quirc");
+    LOG_E("QR", "Failed to allocate quirc");
     return;
   }
   if (quirc_resize(qr, 640, 480) < 0) {
-    Serial.println("[QR] Failed to resize quirc");
+    LOG_E("QR", "Failed to resize quirc");
     quirc_destroy(qr);
     qr = NULL;
     return;
   }
-  Serial.println("[QR] Decoder ready");
+  LOG_I("QR", "Decoder ready");
 }
 
 void scanQRWithCamera() {
@@ -222,30 +275,27 @@ void scanQRWithCamera() {
 
   fb = esp_camera_fb_get();
   if (!fb) {
-    Serial.println("[Camera] Capture failed");
+    LOG_W("Camera", "Capture failed");
     return;
   }
 
-  // Copy image to quirc buffer
-  uint8_t *image = quirc_begin(qr, NULL, NULL);
-  memcpy(image, fb->buf, fb->len);
-  quirc_end(qr);
+  if (!loadQRFrame(qr, fb->buf, fb->width, fb->height)) {
+    LOG_E("QR", "Failed to resize quirc");
+    esp_camera_fb_return(fb);
+    return;
+  }
 
-  // Check for QR codes
+  // Static: quirc_data holds an 8.9 KB payload buffer, too big for the loop stack
+  static QRCodeResult result;
   int count = quirc_count(qr);
   for (int i = 0; i < count; i++) {
-    struct quirc_code code;
-    struct quirc_data data;
-
-    quirc_extract(qr, i, &code);
-    quirc_decode_error_t err = quirc_decode(&code, &data);
+    decodeQRCode(qr, i, result);
 
-    if (err == QUIRC_SUCCESS) {
-      String qrContent = String((char*)data.payload);
-      Serial.println("\n[QR] Code detected!");
-      Serial.println("[QR] Content: " + qrContent);
+    if (result.error == QUIRC_SUCCESS) {
+      String qrContent = String((char*)result.data.payload);
+      LOG_I("QR", "Code detected: %s%s", qrContent.c_str(), result.mirrored ? " (mirrored)" : "");
 
-      processQRContent(qrContent);
+      processQRContent(qrContent, false);
     }
   }
 
@@ -256,7 +306,7 @@ void scanQRWithCamera() {
 // ============== GM65 Scanner Functions ==============
 #if !USE_ESP32_CAM
 void initGM65() {
-  Serial.println("[GM65] Initializing QR Scanner Module...");
+  LOG_I("GM65", "Initializing QR Scanner Module...");
   GM65Serial.begin(9600, SERIAL_8N1, GM65_RX_PIN, GM65_TX_PIN);
 
   // Configure GM65 for continuous scanning
@@ -265,7 +315,7 @@ void initGM65() {
   GM65Serial.write(autoScanCmd, sizeof(autoScanCmd));
 
   delay(100);
-  Serial.println("[GM65] Scanner ready");
+  LOG_I("GM65", "Scanner ready");
 }
 
 void scanQRWithGM65() {
@@ -285,162 +335,323 @@ void scanQRWithGM65() {
     }
 
     if (qrContent.length() > 0) {
-      Serial.println("\n[GM65] Code detected!");
-      Serial.println("[GM65] Content: " + qrContent);
-      processQRContent(qrContent);
+      LOG_I("GM65", "Code detected: %s", qrContent.c_str());
+      processQRContent(qrContent, false);
     }
   }
 }
 #endif
 
 // ============== QR Content Processing ==============
-void processQRContent(String content) {
-  // Try to parse as JSON (OID format from BrainSAIT platform)
-  StaticJsonDocument<1024> doc;
-  DeserializationError error = deserializeJson(doc, content);
-
-  if (!error) {
-    // Valid JSON - check if it's BrainSAIT OID format
-    if (doc.containsKey("oid") || doc.containsKey("path")) {
-      parseOIDJson(doc);
-    } else {
-      Serial.println("[Parse] JSON detected but not BrainSAIT OID format");
-      lastScannedOID.valid = false;
-    }
-  } else {
-    // Not JSON - check if it's a raw OID string
-    if (content.startsWith(BRAINSAIT_OID_ROOT)) {
-      parseRawOID(content);
-    } else {
-      Serial.println("[Parse] Unknown QR format");
-      lastScannedOID.valid = false;
-      errorBeep();
-    }
+/**
+ * Handle one decoded payload
+ * @param synthetic Generated by the load test: skips the buzzer, EEPROM,
+ *        upload and revoked confirmation (delays, flash wear, fake scans).
+ *        Real scans taken during a load run are handled in full.
+ */
+void processQRContent(String content, bool synthetic) {
+  switch (parseScanPayload(content, lastScannedOID)) {
+    case SCAN_FORMAT_JSON_OID:
+      // Validate OID belongs to BrainSAIT namespace
+      if (scanNamespace(lastScannedOID) == SCAN_NAMESPACE_BRAINSAIT) {
+        LOG_I("OID", "Valid BrainSAIT OID detected");
+      } else {
+        LOG_W("OID", "Warning: OID not in BrainSAIT namespace");
+      }
+      break;
+
+    case SCAN_FORMAT_RAW_OID:
+      LOG_I("OID", "Raw OID string detected");
+      break;
+
+    case SCAN_FORMAT_JSON_OTHER:
+      LOG_W("Parse", "JSON detected but not BrainSAIT OID format");
+      break;
+
+    default:
+      LOG_W("Parse", "Unknown QR format");
+      if (!synthetic) errorBeep();
+      break;
+  }
+
+  // Retired asset tags stop here, before display or upload
+  if (lastScannedOID.valid && checkRevoked(lastScannedOID, synthetic)) {
+    if (!synthetic) errorBeep();
+    return;
   }
 
   // Process valid OID
   if (lastScannedOID.valid) {
     displayOIDInfo();
-    successBeep();
+    if (!synthetic) successBeep();
 
-    // Send to API if connected
-    if (wifiConnected) {
+    // Send to API if connected (never for synthetic scans: the round trip
+    // would skew the measured latency and flood the backend with fakes)
+    if (wifiConnected && !synthetic) {
       sendToAPI();
     }
 
-    // Store in local history
-    storeInHistory();
-  }
-}
-
-void parseOIDJson(JsonDocument& doc) {
-  /*
-   * Expected BrainSAIT OID QR JSON format:
-   * {
-   *   "oid": "1.3.6.1.4.1.61026.3.2.1",
-   *   "name": "AI Normalizer Service",
-   *   "description": "Clinical coding and claim normalization service",
-   *   "nodeType": "leaf",
-   *   "status": "active",
-   *   "pen": 61026,
-   *   "provider": "BrainSAIT Enterprise",
-   *   "timestamp": "2025-01-30T10:00:00Z"
-   * }
-   */
-
-  lastScannedOID.oid = doc["oid"] | doc["path"] | "";
-  lastScannedOID.name = doc["name"] | "Unknown";
-  lastScannedOID.description = doc["description"] | "";
-  lastScannedOID.nodeType = doc["nodeType"] | "unknown";
-  lastScannedOID.status = doc["status"] | "unknown";
-  lastScannedOID.timestamp = doc["timestamp"] | "";
-
-  // Validate OID belongs to BrainSAIT namespace
-  if (lastScannedOID.oid.startsWith(BRAINSAIT_OID_ROOT)) {
-    lastScannedOID.valid = true;
-    Serial.println("[OID] Valid BrainSAIT OID detected");
-  } else {
-    Serial.println("[OID] Warning: OID not in BrainSAIT namespace");
-    lastScannedOID.valid = true; // Still process, but flag it
+    // Store in local history and the session index (generated OIDs
+    // would crowd real labels out of its SCAN_INDEX_MAX entries)
+    if (!synthetic) {
+      storeInHistory();
+      indexScan(lastScannedOID.oid);
+    }
   }
 }
 
-void parseRawOID(String oidString) {
-  lastScannedOID.oid = oidString;
-  lastScannedOID.name = "Unknown (raw OID)";
-  lastScannedOID.description = "";
-  lastScannedOID.nodeType = "unknown";
-  lastScannedOID.status = "unknown";
-  lastScannedOID.timestamp = "";
-  lastScannedOID.valid = true;
-
-  Serial.println("[OID] Raw OID string detected");
+/**
+ * Load test entry point (LoadTest::ScanHandler)
+ */
+void processSyntheticContent(String content) {
+  processQRContent(content, true);
 }
 
 void displayOIDInfo() {
-  Serial.println("\n╔════════════════════════════════════════╗");
-  Serial.println("║       BrainSAIT OID SCAN RESULT        ║");
-  Serial.println("╠════════════════════════════════════════╣");
-  Serial.println("║ OID: " + padString(lastScannedOID.oid, 32) + " ║");
-  Serial.println("║ Name: " + padString(lastScannedOID.name, 31) + " ║");
+  LOG_I("Scan", "%s \"%s\" type=%s status=%s", lastScannedOID.oid.c_str(),
+        lastScannedOID.name.c_str(), lastScannedOID.nodeType.c_str(), lastScannedOID.status.c_str());
+
+  LOG_D("Scan", "╔════════════════════════════════════════╗");
+  LOG_D("Scan", "║       BrainSAIT OID SCAN RESULT        ║");
+  LOG_D("Scan", "╠════════════════════════════════════════╣");
+  LOG_D("Scan", "║ OID: %-32.32s ║", lastScannedOID.oid.c_str());
+  LOG_D("Scan", "║ Name: %-31.31s ║", lastScannedOID.name.c_str());
   if (lastScannedOID.description.length() > 0) {
-    Serial.println("║ Desc: " + padString(lastScannedOID.description.substring(0, 31), 31) + " ║");
+    LOG_D("Scan", "║ Desc: %-31.31s ║", lastScannedOID.description.c_str());
   }
-  Serial.println("║ Type: " + padString(lastScannedOID.nodeType, 31) + " ║");
-  Serial.println("║ Status: " + padString(lastScannedOID.status, 29) + " ║");
-  Serial.println("╚════════════════════════════════════════╝\n");
+  LOG_D("Scan", "║ Type: %-31.31s ║", lastScannedOID.nodeType.c_str());
+  LOG_D("Scan", "║ Status: %-29.29s ║", lastScannedOID.status.c_str());
+  LOG_D("Scan", "╚════════════════════════════════════════╝");
 }
 
-String padString(String str, int width) {
-  if (str.length() >= width) {
-    return str.substring(0, width);
+// ============== API Integration ==============
+/**
+ * Connect to BRAINSAIT_API_URL + path
+ * @param timeoutMs Bound on the TCP connect and on the TLS handshake. The
+ *        DNS lookup is only bounded by lwIP's resolver retries.
+ * @return The connected client (plain or TLS), or NULL
+ */
+WiFiClient* connectAPI(const String& path, APIConnection& api, uint32_t timeoutMs) {
+  if (!parseHttpUrl(String(BRAINSAIT_API_URL) + path, api.endpoint)) {
+    LOG_E("API", "Invalid API URL");
+    return NULL;
+  }
+
+  WiFiClient* client = &api.plain;
+  if (api.endpoint.secure) {
+    api.secure.reset(new WiFiClientSecure());
+    api.secure->setInsecure();  // No CA configured (same as HTTPClient default)
+    api.secure->setHandshakeTimeout((timeoutMs + 999) / 1000);  // Seconds; default 120
+    client = api.secure.get();
   }
-  while (str.length() < width) {
-    str += " ";
+
+  if (!client->connect(api.endpoint.host.c_str(), api.endpoint.port, (int32_t)timeoutMs)) {
+    LOG_E("API", "Connection error: connection refused");
+    return NULL;
   }
-  return str;
+  return client;
 }
 
-// ============== API Integration ==============
 void sendToAPI() {
   if (!wifiConnected) return;
 
-  Serial.println("[API] Sending scan data to BrainSAIT...");
+  LOG_D("API", "Sending scan data to BrainSAIT...");
 
-  HTTPClient http;
-  http.begin(String(BRAINSAIT_API_URL) + "/scan");
-  http.addHeader("Content-Type", "application/json");
-  http.addHeader("X-BrainSAIT-API-Key", BRAINSAIT_API_KEY);
-  http.addHeader("X-BrainSAIT-Device", "OID-Scanner-ESP32");
-  http.addHeader("X-BrainSAIT-OID", lastScannedOID.oid);
-  http.addHeader("X-BrainSAIT-PEN", String(BRAINSAIT_PEN));
+  APIConnection api;
+  WiFiClient* client = connectAPI("/scan", api, HTTP_STREAM_TIMEOUT_MS);
+  if (!client) return;
 
-  // Build JSON payload
-  StaticJsonDocument<512> doc;
-  doc["oid"] = lastScannedOID.oid;
-  doc["name"] = lastScannedOID.name;
-  doc["scannedAt"] = millis();
-  doc["deviceIP"] = WiFi.localIP().toString();
-  doc["wifiSSID"] = WIFI_SSID;
+  HttpHeadBuffer head(*client);
+  beginChunkedRequest(head, "POST", api.endpoint, "application/json");
+  writeHttpHeader(head, "X-BrainSAIT-API-Key", BRAINSAIT_API_KEY);
+  writeHttpHeader(head, "X-BrainSAIT-Device", "OID-Scanner-ESP32");
+  writeHttpHeader(head, "X-BrainSAIT-OID", lastScannedOID.oid);
+  writeHttpHeader(head, "X-BrainSAIT-PEN", String(BRAINSAIT_PEN));
+  endHttpHeaders(head);
+  head.send();
 
-  String payload;
-  serializeJson(doc, payload);
+  // Stream the JSON payload straight into the request body
+  ChunkedPrint body(*client);
+  writeScanJson(body, lastScannedOID, millis(), WiFi.localIP().toString(), WIFI_SSID);
+  body.finish();
 
-  int httpCode = http.POST(payload);
+  String response;
+  int httpCode = readHttpResponse(*client, response);
 
   if (httpCode > 0) {
-    if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_CREATED) {
-      Serial.println("[API] Scan recorded successfully");
-      String response = http.getString();
-      Serial.println("[API] Response: " + response);
+    if (httpCode == 200 || httpCode == 201) {
+      LOG_I("API", "Scan recorded successfully");
+      LOG_D("API", "Response: %s", response.c_str());
     } else {
-      Serial.printf("[API] Server error: %d\n", httpCode);
+      LOG_W("API", "Server error: %d", httpCode);
     }
   } else {
-    Serial.printf("[API] Connection error: %s\n", http.errorToString(httpCode).c_str());
+    LOG_E("API", "Connection error: %s", httpStreamErrorName(httpCode));
   }
 
-  http.end();
+  client->stop();
+}
+
+// ============== Revoked OIDs ==============
+void initRevokedFilter() {
+  if (!LittleFS.begin(true)) {
+    LOG_E("Revoked", "Flash filesystem unavailable");
+    return;
+  }
+
+  File file = LittleFS.open(REVOKED_FILTER_PATH, "r");
+  if (!file) {
+    LOG_I("Revoked", "No filter stored yet");
+    return;
+  }
+  if (revokedFilter.load(file)) {
+    LOG_I("Revoked", "Filter loaded: %lu entries, version %lu, %u bytes",
+          (unsigned long)revokedFilter.entries(), (unsigned long)revokedFilter.version(),
+          (unsigned)revokedFilter.sizeBytes());
+  } else {
+    LOG_W("Revoked", "Stored filter is corrupt, waiting for a fresh snapshot");
+  }
+  file.close();
+}
+
+void saveRevokedFilter() {
+  File file = LittleFS.open(REVOKED_FILTER_PATH, "w");
+  if (!file || revokedFilter.save(file) != revokedFilter.sizeBytes()) {
+    LOG_E("Revoked", "Failed to store filter");
+  }
+  if (file) file.close();
+}
+
+/**
+ * Apply revocations added upstream; fetch a full snapshot when there is
+ * no filter yet or the server rebuilt it
+ *
+ * Runs on the sync task. Downloads happen without revokedLock, which is
+ * only taken to apply the result, so scans are never held up by them.
+ */
+void syncRevokedFilter() {
+  if (!wifiConnected) return;
+  lastRevokedSync = millis();
+
+  APIConnection api;
+  int result = REVOKED_SYNC_RESET;
+
+  if (revokedFilter.ready()) {
+    WiFiClient* client = connectAPI("/revoked/delta", api, REVOKED_LOAD_TIMEOUT_MS);
+    if (!client) return;
+    result = fetchRevokedDelta(*client, api.endpoint, BRAINSAIT_API_KEY, revokedFilter,
+                               &revokedLock);
+    client->stop();
+  }
+
+  if (result == REVOKED_SYNC_RESET) {
+    WiFiClient* client = connectAPI("/revoked/filter", api, REVOKED_LOAD_TIMEOUT_MS);
+    if (!client) return;
+    int status = fetchRevokedSnapshot(*client, api.endpoint, BRAINSAIT_API_KEY, revokedFilter,
+                                      &revokedLock);
+    client->stop();
+    if (status != 200) {
+      LOG_W("Revoked", "Snapshot download failed: %d", status);
+      return;
+    }
+    LOG_I("Revoked", "Snapshot: %lu entries, version %lu, %u bytes",
+          (unsigned long)revokedFilter.entries(), (unsigned long)revokedFilter.version(),
+          (unsigned)revokedFilter.sizeBytes());
+    result = 1;
+  } else if (result < 0) {
+    LOG_W("Revoked", "Delta sync failed: %d", result);
+    return;
+  } else {
+    LOG_D("Revoked", "Delta: %d added, now version %lu", result,
+          (unsigned long)revokedFilter.version());
+  }
+
+  // Confirmed false positives may have been revoked since
+  {
+    std::lock_guard<std::mutex> lock(revokedLock);
+    revokedFalsePositives.clear();
+  }
+  // Only this task changes the filter, so it can be read without the lock
+  if (result > 0) saveRevokedFilter();
+}
+
+/**
+ * Sync at start and every REVOKED_SYNC_INTERVAL_MS, or when woken by
+ * "revoked sync"
+ */
+void revokedSyncTask(void*) {
+  while (true) {
+    if (!loadTest.active()) syncRevokedFilter();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REVOKED_SYNC_INTERVAL_MS));
+  }
+}
+
+/**
+ * Check a scan against the revoked filter, asking upstream on a hit
+ * @param synthetic Load test scan: a hit is not confirmed upstream
+ * @return true if the scan must be rejected (scan.status says why)
+ */
+bool checkRevoked(OIDData& scan, bool synthetic) {
+  OIDValue oid;
+  if (!parseOIDValue(scan.oid, oid)) return false;
+  {
+    std::lock_guard<std::mutex> lock(revokedLock);
+    if (!revokedFilter.mayContain(oid) || revokedFalsePositives.contains(oid)) return false;
+  }
+
+  // This runs on the scan loop: connect, TLS handshake and response share
+  // REVOKED_CONFIRM_TIMEOUT_MS (the DNS lookup is outside it; an IP in
+  // BRAINSAIT_API_URL avoids it)
+  RevokedConfirm confirmed = REVOKED_CONFIRM_UNAVAILABLE;
+  if (wifiConnected && !synthetic) {
+    unsigned long start = millis();
+    APIConnection api;
+    WiFiClient* client = connectAPI("/revoked/" + scan.oid, api, REVOKED_CONFIRM_TIMEOUT_MS);
+    if (client) {
+      int status;
+      confirmed = confirmRevoked(*client, api.endpoint, BRAINSAIT_API_KEY, start, status);
+      client->stop();
+      if (confirmed == REVOKED_CONFIRM_UNAVAILABLE && status > 0) {
+        LOG_W("Revoked", "%s: upstream unavailable: HTTP %d", scan.oid.c_str(), status);
+      } else if (confirmed == REVOKED_CONFIRM_UNAVAILABLE) {
+        LOG_W("Revoked", "%s: upstream unavailable: %s", scan.oid.c_str(),
+              httpStreamErrorName(status));
+      }
+    }
+  }
+
+  if (confirmed == REVOKED_CONFIRM_LIVE) {
+    LOG_D("Revoked", "%s: filter false positive", scan.oid.c_str());
+    std::lock_guard<std::mutex> lock(revokedLock);
+    if (revokedFalsePositives.size() < REVOKED_FP_CACHE_MAX) revokedFalsePositives.insert(oid);
+    return false;
+  }
+
+  // Unconfirmed hits fail closed: offline we cannot prove the tag is live
+  bool revoked = confirmed == REVOKED_CONFIRM_REVOKED;
+  scan.status = revoked ? "revoked" : "revoked (unconfirmed)";
+  scan.valid = false;
+  if (revoked) revokedConfirmed++;
+  LOG_W("Revoked", "%s is %s", scan.oid.c_str(), scan.status.c_str());
+  return true;
+}
+
+void printRevokedStatus() {
+  std::lock_guard<std::mutex> lock(revokedLock);
+  if (!revokedFilter.ready()) {
+    logConsole.println("[Revoked] No filter loaded");
+    return;
+  }
+  logConsole.printf("[Revoked] %lu entries, generation %lu, version %lu, %u bytes, k=%u\n",
+                (unsigned long)revokedFilter.entries(), (unsigned long)revokedFilter.generation(),
+                (unsigned long)revokedFilter.version(), (unsigned)revokedFilter.sizeBytes(),
+                (unsigned)revokedFilter.hashCount());
+  logConsole.printf("[Revoked] Expected false positives: %.3f%%\n",
+                revokedFilter.falsePositiveRate() * 100);
+  logConsole.printf("[Revoked] Lookups: %lu, hits: %lu, confirmed: %lu, cached false positives: %u\n",
+                (unsigned long)revokedFilter.lookups(), (unsigned long)revokedFilter.hits(),
+                (unsigned long)revokedConfirmed, (unsigned)revokedFalsePositives.size());
+  logConsole.printf("[Revoked] Last sync: %lu s ago\n", (millis() - lastRevokedSync) / 1000);
 }
 
 // ============== Local Storage ==============
@@ -464,11 +675,11 @@ void storeInHistory() {
   EEPROM.write(0, (count + 1) % 10);
   EEPROM.commit();
 
-  Serial.println("[Storage] Scan saved to local history");
+  LOG_D("Storage", "Scan saved to local history");
 }
 
 void printHistory() {
-  Serial.println("\n[History] Recent scans:");
+  logConsole.println("\n[History] Recent scans:");
   int count = EEPROM.read(0);
   if (count > 10) count = 10;
 
@@ -480,14 +691,62 @@ void printHistory() {
       for (int j = 0; j < len; j++) {
         oid += (char)EEPROM.read(addr + 1 + j);
       }
-      Serial.printf("  %d. %s\n", i + 1, oid.c_str());
+      logConsole.printf("  %d. %s\n", i + 1, oid.c_str());
     }
   }
 }
 
+// ============== Scan Index ==============
+void indexScan(const String& oidString) {
+  OIDValue oid;
+  if (!parseOIDValue(oidString, oid)) return;
+
+  uint16_t* count = scanIndex.find(oid);
+  if (count) {
+    if (*count < UINT16_MAX) (*count)++;
+    return;
+  }
+  if (scanIndex.size() >= SCAN_INDEX_MAX) return;  // Index full for this session
+  scanIndex.put(oid, 1);
+}
+
+void printSubtree(const String& oidString) {
+  OIDValue root;
+  if (!parseOIDValue(oidString, root)) {
+    logConsole.println("[Index] Invalid OID");
+    return;
+  }
+
+  OIDRange range = scanIndex.subtree(root);
+  logConsole.printf("\n[Index] %u scanned OID(s) under %s:\n", (unsigned)range.size(), oidString.c_str());
+
+  char buf[OID_MAX_ARCS * 11];
+  size_t shown = 0;
+  for (size_t i = range.first; i < range.last && shown < 20; i++, shown++) {
+    scanIndex.at(i).toChars(buf, sizeof(buf));
+    logConsole.printf("  %s (x%u)\n", buf, scanIndex.valueAt(i));
+  }
+  if (range.size() > shown) {
+    logConsole.printf("  ... %u more\n", (unsigned)(range.size() - shown));
+  }
+}
+
+void printNextArc(const String& oidString) {
+  OIDValue parent;
+  uint32_t arc;
+  if (!parseOIDValue(oidString, parent)) {
+    logConsole.println("[Index] Invalid OID");
+    return;
+  }
+  if (!scanIndex.nextFreeArc(parent, arc)) {
+    logConsole.println("[Index] No free arc available");
+    return;
+  }
+  logConsole.printf("[Index] Next free arc: %s.%lu\n", oidString.c_str(), (unsigned long)arc);
+}
+
 // ============== Serial Commands ==============
-void handleSerialCommand() {
-  String cmd = Serial.readStringUntil('\n');
+void handleSerialCommand(String cmd) {
   cmd.trim();
   cmd.toLowerCase();
 
@@ -504,37 +763,101 @@ void handleSerialCommand() {
   } else if (cmd.startsWith("test ")) {
     // Test scan with provided OID
     String testOID = cmd.substring(5);
-    processQRContent("{\"oid\":\"" + testOID + "\",\"name\":\"Test Scan\",\"status\":\"test\"}");
+    processQRContent("{\"oid\":\"" + testOID + "\",\"name\":\"Test Scan\",\"status\":\"test\"}", false);
+  } else if (cmd == "revoked") {
+    printRevokedStatus();
+  } else if (cmd == "revoked sync") {
+    xTaskNotifyGive(revokedSyncTaskHandle);
+    logConsole.println("[Revoked] Sync requested");
+  } else if (cmd.startsWith("subtree ")) {
+    printSubtree(cmd.substring(8));
+  } else if (cmd.startsWith("nextarc ")) {
+    printNextArc(cmd.substring(8));
+  } else if (cmd == "load stop") {
+    if (loadTest.active()) {
+      loadTest.stop();
+      loadTest.printReport(logConsole);
+    } else {
+      logConsole.println("[Load] No load test running");
+    }
+  } else if (cmd.startsWith("load ")) {
+    startLoadTest(cmd.substring(5));
   } else {
-    Serial.println("[Cmd] Unknown command. Type 'help' for options.");
+    logConsole.println("[Cmd] Unknown command. Type 'help' for options.");
+  }
+}
+
+void startLoadTest(const String& args) {
+  if (loadTest.active()) {
+    logConsole.println("[Load] Already running. Use 'load stop' first.");
+    return;
   }
+
+  unsigned long count = 0;
+  unsigned long rate = 0;
+  char mixName[16] = "mixed";
+  LoadMix mix;
+
+  int fields = sscanf(args.c_str(), "%lu %lu %15s", &count, &rate, mixName);
+  if (fields < 1 || count == 0 || !parseLoadMix(mixName, mix)) {
+    logConsole.println("[Load] Usage: load <count> [rate/s, 0=max] [json|raw|malformed|duplicate|mixed]");
+    return;
+  }
+
+  logConsole.printf("[Load] Injecting %lu %s payloads at %s\n", count, loadMixName(mix),
+                rate > 0 ? (String(rate) + "/s").c_str() : "max rate");
+  loopTime.reset();
+  loadTest.start(count, rate, mix);
 }
 
 void printHelp() {
-  Serial.println("\n╔════════════════════════════════════════╗");
-  Serial.println("║     BrainSAIT OID Scanner Commands     ║");
-  Serial.println("╠════════════════════════════════════════╣");
-  Serial.println("║ help      - Show this help menu        ║");
-  Serial.println("║ status    - Show device status         ║");
-  Serial.println("║ history   - Show recent scans          ║");
-  Serial.println("║ clear     - Clear scan history         ║");
-  Serial.println("║ reconnect - Reconnect to WiFi          ║");
-  Serial.println("║ test <oid>- Test with specified OID    ║");
-  Serial.println("╚════════════════════════════════════════╝\n");
+  logConsole.println("\n╔════════════════════════════════════════╗");
+  logConsole.println("║     BrainSAIT OID Scanner Commands     ║");
+  logConsole.println("╠════════════════════════════════════════╣");
+  logConsole.println("║ help      - Show this help menu        ║");
+  logConsole.println("║ status    - Show device status         ║");
+  logConsole.println("║ history   - Show recent scans          ║");
+  logConsole.println("║ clear     - Clear scan history         ║");
+  logConsole.println("║ reconnect - Reconnect to WiFi          ║");
+  logConsole.println("║ test <oid>- Test with specified OID    ║");
+  logConsole.println("║ load <n> [rate] [mix]                  ║");
+  logConsole.println("║           - Inject n synthetic scans   ║");
+  logConsole.println("║ load stop - Abort a running load test  ║");
+  logConsole.println("║ subtree <oid> - Scanned OIDs under oid ║");
+  logConsole.println("║ nextarc <oid> - Next unused child arc  ║");
+  logConsole.println("║ revoked   - Revoked OID filter status  ║");
+  logConsole.println("║ revoked sync - Sync filter now         ║");
+  logConsole.println("╚════════════════════════════════════════╝\n");
 }
 
 void printStatus() {
-  Serial.println("\n[Status] Device Information:");
-  Serial.printf("  WiFi: %s\n", wifiConnected ? "Connected" : "Disconnected");
+  logConsole.println("\n[Status] Device Information:");
+  logConsole.printf("  WiFi: %s\n", wifiConnected ? "Connected" : "Disconnected");
   if (wifiConnected) {
-    Serial.print("  IP: ");
-    Serial.println(WiFi.localIP());
-    Serial.printf("  RSSI: %d dBm\n", WiFi.RSSI());
+    logConsole.print("  IP: ");
+    logConsole.println(WiFi.localIP());
+    logConsole.printf("  RSSI: %d dBm\n", WiFi.RSSI());
+  }
+  logConsole.printf("  Free Heap: %d bytes\n", ESP.getFreeHeap());
+  logConsole.printf("  Uptime: %lu ms\n", millis());
+  logConsole.printf("  BrainSAIT PEN: %d\n", BRAINSAIT_PEN);
+  logConsole.printf("  OID Root: %s\n", BRAINSAIT_OID_ROOT);
+  logConsole.printf("  Indexed OIDs: %u/%u\n", (unsigned)scanIndex.size(), SCAN_INDEX_MAX);
+  {
+    std::lock_guard<std::mutex> lock(revokedLock);
+    logConsole.printf("  Revoked filter: %lu entries, version %lu\n",
+                  (unsigned long)revokedFilter.entries(), (unsigned long)revokedFilter.version());
   }
-  Serial.printf("  Free Heap: %d bytes\n", ESP.getFreeHeap());
-  Serial.printf("  Uptime: %lu ms\n", millis());
-  Serial.printf("  BrainSAIT PEN: %d\n", BRAINSAIT_PEN);
-  Serial.printf("  OID Root: %s\n", BRAINSAIT_OID_ROOT);
+  logConsole.printf("  Log: level %d, %lu written, %lu dropped\n", LOG_LEVEL,
+                (unsigned long)logRing.written(), (unsigned long)logRing.dropped());
+  printLoopTime();
+}
+
+void printLoopTime() {
+  logConsole.printf("  Loop time (us): avg=%lu p50=%lu p99=%lu max=%lu over %lu loops\n",
+                (unsigned long)loopTime.meanUs(), (unsigned long)loopTime.percentile(50),
+                (unsigned long)loopTime.percentile(99), (unsigned long)loopTime.maxUs(),
+                (unsigned long)loopTime.count());
 }
 
 void clearHistory() {
@@ -542,7 +865,7 @@ void clearHistory() {
     EEPROM.write(i, 0);
   }
   EEPROM.commit();
-  Serial.println("[Storage] History cleared");
+  logConsole.println("[Storage] History cleared");
 }
 
 // ============== Feedback Functions ==============
@@ -0,0 +1,340 @@
+/**
+ * BrainSAIT OID Ordered Containers
+ *
+ * Flat, sorted OID set and map. Because OIDValue orders arc-wise, every
+ * subtree is one contiguous range, so descendant enumeration, counting
+ * and next-free-arc lookups cost O(log n + k) instead of a string
+ * compare against every entry.
+ */
+
+#ifndef OID_SET_H
+#define OID_SET_H
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "oid_utils.h"
+
+/**
+ * Index range [first, last) within an ordered OID container
+ */
+struct OIDRange {
+  size_t first;
+  size_t last;
+
+  size_t size() const { return last - first; }
+  bool empty() const { return first == last; }
+};
+
+/**
+ * One key's place in the shared arc pool
+ */
+struct OIDKeyRef {
+  uint32_t offset;  // Index of the first arc
+  uint8_t depth;
+};
+
+/**
+ * Sorted unique OID keys with subtree queries
+ *
+ * Keys are stored variable-length: arcs go into one shared pool and each
+ * key is an offset plus depth, so a key costs sizeof(OIDKeyRef) plus 4
+ * bytes per arc rather than a full OIDValue. Lookups take an OIDValue;
+ * at() copies a key back out into one.
+ */
+class OIDSortedKeys {
+public:
+  static const size_t npos = (size_t)-1;
+
+  size_t size() const { return _refs.size(); }
+  bool empty() const { return _refs.empty(); }
+
+  /**
+   * Copy the key at index into an OIDValue
+   */
+  OIDValue at(size_t index) const {
+    OIDValue oid;
+    const OIDKeyRef& ref = _refs[index];
+    memcpy(oid.arcs, _arcs.data() + ref.offset, ref.depth * sizeof(uint32_t));
+    oid.depth = ref.depth;
+    return oid;
+  }
+
+  /**
+   * Bytes held by the keys (index plus arc pool, excluding spare capacity)
+   */
+  size_t memoryUsed() const {
+    return _refs.size() * sizeof(OIDKeyRef) + _arcs.size() * sizeof(uint32_t);
+  }
+
+  /**
+   * Index of the first key not less than oid
+   */
+  size_t lowerBound(const OIDValue& oid) const {
+    return lowerBound(oid, 0, _refs.size());
+  }
+
+  /**
+   * Index of oid, or npos
+   */
+  size_t indexOf(const OIDValue& oid) const {
+    size_t i = lowerBound(oid);
+    return i < _refs.size() && compareKey(i, oid) == 0 ? i : npos;
+  }
+
+  bool contains(const OIDValue& oid) const { return indexOf(oid) != npos; }
+
+  /**
+   * Range holding root (if present) and all of its descendants
+   * @param root Subtree root
+   * @param includeRoot Whether root itself belongs to the range
+   */
+  OIDRange subtree(const OIDValue& root, bool includeRoot = true) const {
+    size_t first = lowerBound(root);
+
+    // Keys under root follow it contiguously: find where they stop
+    size_t lo = first, hi = _refs.size();
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (hasPrefix(mid, root)) lo = mid + 1;
+      else hi = mid;
+    }
+
+    if (!includeRoot && first != lo && _refs[first].depth == root.depth) ++first;
+
+    OIDRange range = { first, lo };
+    return range;
+  }
+
+  /**
+   * Number of strict descendants of root
+   */
+  size_t countDescendants(const OIDValue& root) const {
+    return subtree(root, false).size();
+  }
+
+  /**
+   * Lowest child arc of parent not used by any key in its subtree
+   *
+   * An arc counts as used if the child itself or any of its descendants
+   * is present. Runs of used arcs are skipped with one binary search each.
+   *
+   * @param parent Parent OID
+   * @param arc Receives the free arc
+   * @param firstArc Lowest arc to consider (BrainSAIT branches start at 1)
+   * @return false if parent is at OID_MAX_ARCS or no arc is free
+   */
+  bool nextFreeArc(const OIDValue& parent, uint32_t& arc, uint32_t firstArc = 1) const {
+    if (parent.depth >= OID_MAX_ARCS) return false;
+
+    uint8_t d = parent.depth;
+    OIDValue probe;
+    parent.child(firstArc, probe);
+
+    size_t i = lowerBound(probe);
+    uint32_t candidate = firstArc;
+    while (i < _refs.size() && _refs[i].depth > d && hasPrefix(i, parent) &&
+           _arcs[_refs[i].offset + d] == candidate) {
+      if (candidate == UINT32_MAX) return false;
+      candidate++;
+      probe.arcs[d] = candidate;
+      i = lowerBound(probe, i, _refs.size());
+    }
+
+    arc = candidate;
+    return true;
+  }
+
+protected:
+  /**
+   * Compare key number index with oid, arc by arc
+   * @return <0, 0 or >0
+   */
+  int compareKey(size_t index, const OIDValue& oid) const {
+    const OIDKeyRef& ref = _refs[index];
+    const uint32_t* arcs = _arcs.data() + ref.offset;
+    uint8_t n = ref.depth < oid.depth ? ref.depth : oid.depth;
+    for (uint8_t i = 0; i < n; i++) {
+      if (arcs[i] != oid.arcs[i]) return arcs[i] < oid.arcs[i] ? -1 : 1;
+    }
+    return (int)ref.depth - (int)oid.depth;
+  }
+
+  void reserveKeys(size_t n, size_t arcsPerKey) {
+    _refs.reserve(n);
+    _arcs.reserve(n * arcsPerKey);
+  }
+
+  void clearKeys() {
+    _refs.clear();
+    _arcs.clear();
+  }
+
+  /**
+   * Insert oid as key number index (the caller keeps the order)
+   */
+  void insertKey(size_t index, const OIDValue& oid) {
+    OIDKeyRef ref = { (uint32_t)_arcs.size(), oid.depth };
+    _arcs.insert(_arcs.end(), oid.arcs, oid.arcs + oid.depth);
+    _refs.insert(_refs.begin() + index, ref);
+  }
+
+  /**
+   * Remove key number index and close the gap in the arc pool
+   */
+  void eraseKey(size_t index) {
+    OIDKeyRef ref = _refs[index];
+    _refs.erase(_refs.begin() + index);
+    _arcs.erase(_arcs.begin() + ref.offset, _arcs.begin() + ref.offset + ref.depth);
+    for (OIDKeyRef& other : _refs) {
+      if (other.offset > ref.offset) other.offset -= ref.depth;
+    }
+  }
+
+  /**
+   * Replace all keys with sorted, unique oids
+   */
+  void assignKeys(const std::vector<OIDValue>& oids) {
+    clearKeys();
+    size_t arcs = 0;
+    for (const OIDValue& oid : oids) arcs += oid.depth;
+    _refs.reserve(oids.size());
+    _arcs.reserve(arcs);
+    for (const OIDValue& oid : oids) insertKey(_refs.size(), oid);
+  }
+
+private:
+  /**
+   * Check whether prefix equals or is an ancestor of key number index
+   */
+  bool hasPrefix(size_t index, const OIDValue& prefix) const {
+    const OIDKeyRef& ref = _refs[index];
+    if (prefix.depth > ref.depth) return false;
+    return memcmp(_arcs.data() + ref.offset, prefix.arcs, prefix.depth * sizeof(uint32_t)) == 0;
+  }
+
+  size_t lowerBound(const OIDValue& oid, size_t lo, size_t hi) const {
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (compareKey(mid, oid) < 0) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+
+  std::vector<OIDKeyRef> _refs;
+  std::vector<uint32_t> _arcs;
+};
+
+/**
+ * Sorted OID set
+ */
+class OIDSet : public OIDSortedKeys {
+public:
+  /**
+   * @param arcsPerKey Expected average depth, for the arc pool
+   */
+  void reserve(size_t n, size_t arcsPerKey = 10) { reserveKeys(n, arcsPerKey); }
+  void clear() { clearKeys(); }
+
+  /**
+   * Insert one OID (O(n) shift; use assign() for bulk loads)
+   * @return false if already present
+   */
+  bool insert(const OIDValue& oid) {
+    size_t i = lowerBound(oid);
+    if (i < size() && compareKey(i, oid) == 0) return false;
+    insertKey(i, oid);
+    return true;
+  }
+
+  bool erase(const OIDValue& oid) {
+    size_t i = indexOf(oid);
+    if (i == npos) return false;
+    eraseKey(i);
+    return true;
+  }
+
+  /**
+   * Replace contents with an unsorted batch in O(n log n)
+   */
+  void assign(std::vector<OIDValue> oids) {
+    std::sort(oids.begin(), oids.end());
+    oids.erase(std::unique(oids.begin(), oids.end()), oids.end());
+    assignKeys(oids);
+  }
+};
+
+/**
+ * Sorted OID map with values stored alongside the keys
+ */
+template <typename T>
+class OIDMap : public OIDSortedKeys {
+public:
+  /**
+   * @param arcsPerKey Expected average depth, for the arc pool
+   */
+  void reserve(size_t n, size_t arcsPerKey = 10) {
+    reserveKeys(n, arcsPerKey);
+    _values.reserve(n);
+  }
+
+  void clear() {
+    clearKeys();
+    _values.clear();
+  }
+
+  T& valueAt(size_t index) { return _values[index]; }
+  const T& valueAt(size_t index) const { return _values[index]; }
+
+  /**
+   * Find the value for oid
+   * @return NULL if absent
+   */
+  T* find(const OIDValue& oid) {
+    size_t i = indexOf(oid);
+    return i == npos ? NULL : &_values[i];
+  }
+
+  /**
+   * Insert or overwrite
+   * @return true if a new key was added
+   */
+  bool put(const OIDValue& oid, const T& value) {
+    size_t i = lowerBound(oid);
+    if (i < size() && compareKey(i, oid) == 0) {
+      _values[i] = value;
+      return false;
+    }
+    insertKey(i, oid);
+    _values.insert(_values.begin() + i, value);
+    return true;
+  }
+
+  /**
+   * Get the value for oid, inserting a default if absent
+   */
+  T& operator[](const OIDValue& oid) {
+    size_t i = lowerBound(oid);
+    if (i == size() || compareKey(i, oid) != 0) {
+      insertKey(i, oid);
+      _values.insert(_values.begin() + i, T());
+    }
+    return _values[i];
+  }
+
+  bool erase(const OIDValue& oid) {
+    size_t i = indexOf(oid);
+    if (i == npos) return false;
+    eraseKey(i);
+    _values.erase(_values.begin() + i);
+    return true;
+  }
+
+private:
+  std::vector<T> _values;
+};
+
+#endif // OID_SET_H
@@ -110,20 +110,11 @@ bool validateOIDFormat(const String& oidString) {
 }
 
 /**
- * Check if OID belongs to BrainSAIT namespace
- * @param oidString The OID string
- * @return true if under 1.3.6.1.4.1.61026
- */
-bool isBrainSAITOID(const String& oidString) {
-  return oidString.startsWith(BRAINSAIT_ROOT);
-}
-
-/**
- * Get the branch name for a BrainSAIT OID
+ * Get the branch name for a BrainSAIT OID without allocating
  * @param oid Parsed OID structure
  * @return Human-readable branch name
  */
-String getBranchName(const OID& oid) {
+const char* branchName(const OID& oid) {
   if (!oid.isBrainSAIT || oid.depth < 8) {
     return "Unknown";
   }
@@ -137,6 +128,15 @@ String getBranchName(const OID& oid) {
   }
 }
 
+/**
+ * Get the branch name for a BrainSAIT OID
+ * @param oid Parsed OID structure
+ * @return Human-readable branch name
+ */
+String getBranchName(const OID& oid) {
+  return String(branchName(oid));
+}
+
 /**
  * Get sub-branch details for Products (branch 3)
  * @param oid Parsed OID structure
@@ -213,6 +213,173 @@ String createChildOID(const String& parentOID, int childArc) {
   return parentOID + "." + String(childArc);
 }
 
+// ============== OID Value Type ==============
+
+#ifndef OID_MAX_ARCS
+#define OID_MAX_ARCS 20
+#endif
+
+/**
+ * Compact, allocation-free OID value
+ *
+ * Orders arc-wise lexicographically, so an OID sorts directly before
+ * all of its descendants and every subtree is a contiguous range.
+ */
+struct OIDValue {
+  uint32_t arcs[OID_MAX_ARCS];
+  uint8_t depth;
+
+  OIDValue() : depth(0) {}
+
+  /**
+   * Compare arc by arc; a proper prefix sorts first
+   * @return <0, 0 or >0
+   */
+  int compare(const OIDValue& other) const {
+    uint8_t n = depth < other.depth ? depth : other.depth;
+    for (uint8_t i = 0; i < n; i++) {
+      if (arcs[i] != other.arcs[i]) return arcs[i] < other.arcs[i] ? -1 : 1;
+    }
+    return (int)depth - (int)other.depth;
+  }
+
+  bool operator<(const OIDValue& other) const { return compare(other) < 0; }
+  bool operator==(const OIDValue& other) const { return compare(other) == 0; }
+  bool operator!=(const OIDValue& other) const { return compare(other) != 0; }
+
+  /**
+   * Check whether this OID equals or is an ancestor of another
+   */
+  bool isPrefixOf(const OIDValue& other) const {
+    if (depth > other.depth) return false;
+    for (uint8_t i = 0; i < depth; i++) {
+      if (arcs[i] != other.arcs[i]) return false;
+    }
+    return true;
+  }
+
+  /**
+   * Check whether this OID is a strict descendant of another
+   */
+  bool isDescendantOf(const OIDValue& ancestor) const {
+    return ancestor.depth < depth && ancestor.isPrefixOf(*this);
+  }
+
+  /**
+   * Get parent OID without allocating
+   * @return false for an empty OID
+   */
+  bool parent(OIDValue& out) const {
+    if (depth == 0) return false;
+    out = *this;
+    out.depth--;
+    return true;
+  }
+
+  /**
+   * Get child OID without allocating
+   * @return false if OID_MAX_ARCS would be exceeded
+   */
+  bool child(uint32_t arc, OIDValue& out) const {
+    if (depth >= OID_MAX_ARCS) return false;
+    out = *this;
+    out.arcs[out.depth++] = arc;
+    return true;
+  }
+
+  /**
+   * FNV-1a hash over the arcs
+   */
+  uint32_t hash() const {
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < depth; i++) {
+      uint32_t arc = arcs[i];
+      for (int b = 0; b < 4; b++) {
+        h ^= (arc >> (b * 8)) & 0xFF;
+        h *= 16777619u;
+      }
+    }
+    return h ^ depth;
+  }
+
+  /**
+   * Format as dotted string into a caller buffer
+   * @return Characters written (excluding terminator)
+   */
+  size_t toChars(char* buf, size_t size) const {
+    if (size == 0) return 0;
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < depth && pos < size; i++) {
+      int n = snprintf(buf + pos, size - pos, i ? ".%lu" : "%lu", (unsigned long)arcs[i]);
+      if (n < 0) break;
+      pos += (size_t)n;
+    }
+    return pos < size ? pos : size - 1;
+  }
+
+  String toString() const {
+    char buf[OID_MAX_ARCS * 11];
+    toChars(buf, sizeof(buf));
+    return String(buf);
+  }
+};
+
+/**
+ * Hash functor for unordered containers on the host
+ */
+struct OIDValueHash {
+  size_t operator()(const OIDValue& oid) const { return oid.hash(); }
+};
+
+/**
+ * Parse a dotted OID string into an OIDValue
+ * @param oidString OID string (e.g., "1.3.6.1.4.1.61026.3.2")
+ * @param out Parsed value
+ * @return false on bad format, arc overflow or more than OID_MAX_ARCS arcs
+ */
+bool parseOIDValue(const char* oidString, OIDValue& out) {
+  out.depth = 0;
+  if (!oidString || !isDigit(*oidString)) return false;
+
+  const char* p = oidString;
+  while (true) {
+    if (!isDigit(*p) || out.depth >= OID_MAX_ARCS) return false;
+
+    uint64_t arc = 0;
+    while (isDigit(*p)) {
+      arc = arc * 10 + (uint64_t)(*p++ - '0');
+      if (arc > UINT32_MAX) return false;
+    }
+    out.arcs[out.depth++] = (uint32_t)arc;
+
+    if (*p == '\0') return true;
+    if (*p++ != '.') return false;
+  }
+}
+
+bool parseOIDValue(const String& oidString, OIDValue& out) {
+  return parseOIDValue(oidString.c_str(), out);
+}
+
+/**
+ * Check if OID belongs to BrainSAIT namespace
+ *
+ * Compares arcs, so "1.3.6.1.4.1.610260" is foreign even though it
+ * starts with the root's text.
+ * @return true for 1.3.6.1.4.1.61026 and its descendants
+ */
+bool isBrainSAITOID(const OIDValue& oid) {
+  OIDValue root;
+  parseOIDValue(BRAINSAIT_ROOT, root);
+  return root.isPrefixOf(oid);
+}
+
+bool isBrainSAITOID(const String& oidString) {
+  OIDValue oid;
+  return parseOIDValue(oidString, oid) && isBrainSAITOID(oid);
+}
+
 /**
  * Convert OID to URN format
  * @param oidString The OID string
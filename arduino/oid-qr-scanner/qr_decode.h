@@ -0,0 +1,79 @@
+/**
+ * BrainSAIT OID Scanner - QR Frame Decoding
+ *
+ * Loads a grayscale frame into quirc and decodes the codes it finds.
+ * Shared by the ESP32-CAM scan loop and the host label audit, so both
+ * decode a code the same way. The audit builds quirc with a much larger
+ * QUIRC_MAX_REGIONS to fit whole label sheets, so a crowded frame it
+ * accepts can still exceed the firmware's region limit.
+ */
+
+#ifndef QR_DECODE_H
+#define QR_DECODE_H
+
+#include <Arduino.h>
+
+#include "quirc.h"
+
+/**
+ * Outcome of decoding one code found in a frame
+ */
+struct QRCodeResult {
+  quirc_decode_error_t error;   // QUIRC_SUCCESS or why decoding failed
+  bool mirrored;                // Only decoded after flipping (mirror-printed label)
+  struct quirc_data data;       // Version, ECC level and payload on success
+};
+
+/**
+ * Copy a grayscale frame into quirc and locate codes
+ * @param qr Decoder; resized when the frame size changes
+ * @param gray One byte per pixel, row-major
+ * @return false if the decoder buffer cannot be allocated
+ */
+bool loadQRFrame(struct quirc* qr, const uint8_t* gray, int width, int height) {
+  int w, h;
+  uint8_t* image = quirc_begin(qr, &w, &h);
+  if (w != width || h != height) {
+    if (quirc_resize(qr, width, height) < 0) return false;
+    image = quirc_begin(qr, NULL, NULL);
+  }
+  memcpy(image, gray, (size_t)width * height);
+  quirc_end(qr);
+  return true;
+}
+
+/**
+ * Decode code `index` of the last frame (0 <= index < quirc_count())
+ *
+ * A code that fails error correction is retried mirrored, since labels
+ * printed from a flipped template otherwise never decode.
+ */
+void decodeQRCode(struct quirc* qr, int index, QRCodeResult& result) {
+  struct quirc_code code;
+  quirc_extract(qr, index, &code);
+
+  result.mirrored = false;
+  result.error = quirc_decode(&code, &result.data);
+  if (result.error == QUIRC_ERROR_DATA_ECC) {
+    quirc_flip(&code);
+    if (quirc_decode(&code, &result.data) == QUIRC_SUCCESS) {
+      result.error = QUIRC_SUCCESS;
+      result.mirrored = true;
+    }
+  }
+}
+
+/**
+ * Get the ECC level letter of a decoded code
+ */
+char qrEccLevelName(int eccLevel) {
+  switch (eccLevel) {
+    case QUIRC_ECC_LEVEL_L: return 'L';
+    case QUIRC_ECC_LEVEL_M: return 'M';
+    case QUIRC_ECC_LEVEL_Q: return 'Q';
+    case QUIRC_ECC_LEVEL_H: return 'H';
+    default:                return '?';
+  }
+}
+
+#endif // QR_DECODE_H
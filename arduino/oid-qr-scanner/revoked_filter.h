@@ -0,0 +1,468 @@
+/**
+ * BrainSAIT OID Scanner - Revoked OID Filter
+ *
+ * Bloom filter of revoked or retired OIDs, kept in flash and checked
+ * before a scan is displayed or uploaded. A miss means "not revoked as of
+ * the last sync"; a hit is probably revoked and is confirmed upstream
+ * when online.
+ *
+ * Sync protocol (relative to BRAINSAIT_API_URL):
+ *   GET /revoked/filter                 Full snapshot (header + bits)
+ *   GET /revoked/delta?generation=G&since=V
+ *       200: "generation G version V2\n" then V2 - V added OIDs, one per
+ *            line; applied only once all of them (Content-Length) arrived
+ *       409: generation changed, fetch a new snapshot
+ *   GET /revoked/<oid>                  200 revoked, 404 not revoked
+ */
+
+#ifndef REVOKED_FILTER_H
+#define REVOKED_FILTER_H
+
+#include <Arduino.h>
+#include <math.h>
+
+#include <mutex>
+
+#include "oid_utils.h"
+#include "http_stream.h"
+
+#define REVOKED_FILTER_MAGIC     0x314B5652UL   // "RVK1" little-endian
+
+#ifndef REVOKED_FILTER_MAX_BYTES
+#define REVOKED_FILTER_MAX_BYTES (256UL * 1024)  // Largest snapshot accepted
+#endif
+
+#ifndef REVOKED_FILTER_HEADROOM
+#define REVOKED_FILTER_HEADROOM  0.25f           // Spare capacity when a filter is built
+#endif
+
+#ifndef REVOKED_FILTER_PATH
+#define REVOKED_FILTER_PATH      "/revoked.bin"
+#endif
+
+#ifndef REVOKED_LOAD_TIMEOUT_MS
+#define REVOKED_LOAD_TIMEOUT_MS  15000           // Snapshot or delta download
+#endif
+
+#ifndef REVOKED_CONFIRM_TIMEOUT_MS
+#define REVOKED_CONFIRM_TIMEOUT_MS 2000          // Upstream check of a filter hit:
+#endif                                           // connect, TLS handshake and response
+
+#ifndef REVOKED_DELTA_MAX
+#define REVOKED_DELTA_MAX        1024            // Larger deltas fetch a snapshot instead
+#endif
+
+// Result of fetchRevokedDelta() when the snapshot must be replaced
+#define REVOKED_SYNC_RESET       -10
+
+/**
+ * Snapshot header, stored little-endian ahead of the bit array
+ */
+struct RevokedFilterHeader {
+  uint32_t magic;
+  uint32_t bitCount;      // Multiple of 8
+  uint8_t hashCount;
+  uint8_t reserved[3];
+  uint32_t generation;    // Changes when the filter is rebuilt
+  uint32_t version;       // Revocations included so far
+  uint32_t entries;       // OIDs inserted (for the false-positive estimate)
+};
+
+/**
+ * 64-bit hash of an OID's arcs (FNV-1a with a splitmix64 finish)
+ *
+ * Hashing parsed arcs rather than text makes "1.3.6.1" and "1.3.6.01"
+ * the same key.
+ */
+uint64_t revokedKeyHash(const OIDValue& oid) {
+  uint64_t h = 14695981039346656037ULL;
+  for (uint8_t i = 0; i < oid.depth; i++) {
+    uint32_t arc = oid.arcs[i];
+    for (uint8_t b = 0; b < 4; b++) {
+      h ^= (arc >> (8 * b)) & 0xFF;
+      h *= 1099511628211ULL;
+    }
+  }
+  h ^= oid.depth;
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBULL;
+  h ^= h >> 31;
+  return h;
+}
+
+/**
+ * Bloom filter over OIDValue keys
+ *
+ * Bit positions come from double hashing (h1 + i*h2) mapped onto the
+ * bit count with a multiply-shift, so any size works without a modulo.
+ */
+class RevokedFilter {
+public:
+  RevokedFilter() { memset(&_header, 0, sizeof(_header)); }
+  ~RevokedFilter() { free(_bits); }
+
+  RevokedFilter(const RevokedFilter&) = delete;
+  RevokedFilter& operator=(const RevokedFilter&) = delete;
+
+  /**
+   * Allocate an empty filter
+   * @param bitCount Filter size in bits (rounded up to a byte)
+   * @param hashCount Bits set per entry
+   */
+  bool create(uint32_t bitCount, uint8_t hashCount, uint32_t generation = 1) {
+    bitCount = (bitCount + 7) & ~7UL;
+    if (bitCount == 0 || bitCount / 8 > REVOKED_FILTER_MAX_BYTES || hashCount == 0) return false;
+
+    uint8_t* bits = (uint8_t*)calloc(bitCount / 8, 1);
+    if (!bits) return false;
+    free(_bits);
+    _bits = bits;
+
+    memset(&_header, 0, sizeof(_header));
+    _header.magic = REVOKED_FILTER_MAGIC;
+    _header.bitCount = bitCount;
+    _header.hashCount = hashCount;
+    _header.generation = generation;
+    return true;
+  }
+
+  /**
+   * Allocate an empty filter sized for an expected number of entries
+   * @param bitsPerEntry Memory per entry; 10 gives about 1% false positives
+   */
+  bool createFor(uint32_t capacity, float bitsPerEntry, uint32_t generation = 1) {
+    uint8_t k = (uint8_t)(bitsPerEntry * 0.6931f + 0.5f);
+    return create((uint32_t)(capacity * bitsPerEntry), k ? k : 1, generation);
+  }
+
+  void add(const OIDValue& oid) { addHash(revokedKeyHash(oid)); }
+
+  /** Add a key already hashed with revokedKeyHash() */
+  void addHash(uint64_t h) {
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+    for (uint8_t i = 0; i < _header.hashCount; i++) {
+      uint32_t bit = position(h1 + i * h2);
+      _bits[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+    }
+    _header.entries++;
+  }
+
+  /**
+   * @return false if the OID is definitely not in the filter
+   */
+  bool mayContain(const OIDValue& oid) const {
+    if (!_bits) return false;
+    _lookups++;
+    uint64_t h = revokedKeyHash(oid);
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+    for (uint8_t i = 0; i < _header.hashCount; i++) {
+      uint32_t bit = position(h1 + i * h2);
+      if (!(_bits[bit >> 3] & (1 << (bit & 7)))) return false;
+    }
+    _hits++;
+    return true;
+  }
+
+  /**
+   * Read a snapshot (header + bits) from a file or RevokedClientReader
+   * @param timeoutMs Wait for slow data; 0 fails on the first short read.
+   *        A negative read() (peer closed) fails at once.
+   */
+  template <typename TStream>
+  bool load(TStream& in, unsigned long timeoutMs = 0) {
+    unsigned long start = millis();
+    RevokedFilterHeader header;
+    if (!readFully(in, (uint8_t*)&header, sizeof(header), start, timeoutMs)) return false;
+    if (header.magic != REVOKED_FILTER_MAGIC || header.bitCount == 0 || header.bitCount % 8 ||
+        header.bitCount / 8 > REVOKED_FILTER_MAX_BYTES || header.hashCount == 0) {
+      return false;
+    }
+
+    uint8_t* bits = (uint8_t*)malloc(header.bitCount / 8);
+    if (!bits) return false;
+    if (!readFully(in, bits, header.bitCount / 8, start, timeoutMs)) {
+      free(bits);
+      return false;
+    }
+
+    free(_bits);
+    _bits = bits;
+    _header = header;
+    return true;
+  }
+
+  /**
+   * Write the snapshot (header + bits)
+   * @return Bytes written
+   */
+  size_t save(Print& out) const {
+    if (!_bits) return 0;
+    size_t n = out.write((const uint8_t*)&_header, sizeof(_header));
+    return n + out.write(_bits, _header.bitCount / 8);
+  }
+
+  /** Take over another filter's contents (e.g. a freshly downloaded snapshot) */
+  void swap(RevokedFilter& other) {
+    uint8_t* bits = _bits;
+    _bits = other._bits;
+    other._bits = bits;
+    RevokedFilterHeader header = _header;
+    _header = other._header;
+    other._header = header;
+  }
+
+  void setVersion(uint32_t version) { _header.version = version; }
+
+  bool ready() const { return _bits != NULL; }
+  uint32_t bitCount() const { return _header.bitCount; }
+  uint8_t hashCount() const { return _header.hashCount; }
+  uint32_t generation() const { return _header.generation; }
+  uint32_t version() const { return _header.version; }
+  uint32_t entries() const { return _header.entries; }
+  size_t sizeBytes() const { return _bits ? sizeof(_header) + _header.bitCount / 8 : 0; }
+  uint32_t lookups() const { return _lookups; }
+  uint32_t hits() const { return _hits; }
+
+  /** Expected false-positive rate at the current fill */
+  float falsePositiveRate() const {
+    if (!_bits || _header.entries == 0) return 0;
+    float k = _header.hashCount;
+    return powf(1.0f - expf(-k * _header.entries / _header.bitCount), k);
+  }
+
+private:
+  uint32_t position(uint32_t hash) const {
+    return (uint32_t)(((uint64_t)hash * _header.bitCount) >> 32);
+  }
+
+  template <typename TStream>
+  static bool readFully(TStream& in, uint8_t* buf, size_t n, unsigned long start,
+                        unsigned long timeoutMs) {
+    size_t got = 0;
+    while (got < n) {
+      int r = (int)in.read(buf + got, n - got);
+      if (r > 0) {
+        got += r;
+      } else if (r < 0 || timeoutMs == 0 || millis() - start >= timeoutMs) {
+        return false;
+      } else {
+        delay(1);
+      }
+    }
+    return true;
+  }
+
+  RevokedFilterHeader _header;
+  uint8_t* _bits = NULL;
+  mutable uint32_t _lookups = 0;
+  mutable uint32_t _hits = 0;
+};
+
+/**
+ * Entries to size a filter for: the current count plus
+ * REVOKED_FILTER_HEADROOM, at least 1024, at most what fits in
+ * REVOKED_FILTER_MAX_BYTES
+ * @return 0 if entries alone do not fit
+ */
+uint32_t revokedFilterCapacity(uint32_t entries, float bitsPerEntry) {
+  if (bitsPerEntry <= 0) return 0;
+  uint32_t maxEntries = (uint32_t)(REVOKED_FILTER_MAX_BYTES * 8 / bitsPerEntry);
+  if (entries > maxEntries) return 0;
+
+  uint32_t capacity = entries + (uint32_t)(entries * REVOKED_FILTER_HEADROOM);
+  if (capacity < 1024) capacity = 1024;
+  return capacity < maxEntries ? capacity : maxEntries;
+}
+
+// ============== Sync ==============
+
+/**
+ * Network client as a RevokedFilter::load() source: read() returns 0
+ * while data may still come and -1 once the peer has closed
+ */
+template <typename TClient>
+class RevokedClientReader {
+public:
+  explicit RevokedClientReader(TClient& client) : _client(client) {}
+
+  int read(uint8_t* buf, size_t n) {
+    int available = _client.available();
+    if (available <= 0) return _client.connected() ? 0 : -1;
+    return _client.read(buf, n < (size_t)available ? n : (size_t)available);
+  }
+
+private:
+  TClient& _client;
+};
+
+void sendRevokedRequest(Print& out, const HttpEndpoint& endpoint, const char* apiKey) {
+  HttpHeadBuffer head(out);
+  beginRequest(head, "GET", endpoint);
+  writeHttpHeader(head, "X-BrainSAIT-API-Key", apiKey);
+  endHttpHeaders(head);
+  head.send();
+}
+
+/**
+ * Download a full snapshot into filter (replaced only on success)
+ * @param client Client connected to endpoint's host
+ * @param endpoint .../revoked/filter
+ * @param lock Held only while the new snapshot is swapped in, so readers
+ *        on another task are not blocked by the download
+ * @return HTTP status (200 on success), or a negative HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+int fetchRevokedSnapshot(TClient& client, const HttpEndpoint& endpoint, const char* apiKey,
+                         RevokedFilter& filter, std::mutex* lock = NULL) {
+  sendRevokedRequest(client, endpoint, apiKey);
+
+  long contentLength;
+  int status = readHttpHead(client, contentLength);
+  if (status != 200) return status;
+
+  RevokedFilter fresh;
+  RevokedClientReader<TClient> reader(client);
+  if (!fresh.load(reader, REVOKED_LOAD_TIMEOUT_MS)) return HTTP_STREAM_ERROR_BAD_RESPONSE;
+  if (lock) lock->lock();
+  filter.swap(fresh);
+  if (lock) lock->unlock();
+  return status;
+}
+
+/**
+ * Read one '\n'-terminated line of a body with `remaining` bytes left
+ * @return Line length, HTTP_STREAM_ERROR_BAD_RESPONSE if the body ends
+ *         mid-line or the line is too long, or another HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+int readRevokedBodyLine(TClient& client, char* line, size_t size, long& remaining,
+                        unsigned long start) {
+  size_t len = 0;
+  while (remaining > 0) {
+    if (!client.available()) {
+      if (!client.connected()) return HTTP_STREAM_ERROR_CLOSED;
+      if (millis() - start >= REVOKED_LOAD_TIMEOUT_MS) return HTTP_STREAM_ERROR_TIMEOUT;
+      delay(1);
+      continue;
+    }
+
+    int c = client.read();
+    if (c < 0) continue;
+    remaining--;
+    if (c == '\n') {
+      line[len] = '\0';
+      return (int)len;
+    }
+    if (len == size - 1) return HTTP_STREAM_ERROR_BAD_RESPONSE;
+    line[len++] = (char)c;
+  }
+  return HTTP_STREAM_ERROR_BAD_RESPONSE;
+}
+
+/**
+ * Fetch and apply revocations added since the filter's version
+ * @param endpoint .../revoked/delta (query added here)
+ * @param lock Held only while the delta is applied
+ * @return OIDs applied (>= 0), REVOKED_SYNC_RESET, a negative
+ *         HTTP_STREAM_ERROR_*, or -status for other HTTP statuses
+ */
+template <typename TClient>
+int fetchRevokedDelta(TClient& client, HttpEndpoint endpoint, const char* apiKey,
+                      RevokedFilter& filter, std::mutex* lock = NULL) {
+  char query[48];
+  snprintf(query, sizeof(query), "?generation=%lu&since=%lu",
+           (unsigned long)filter.generation(), (unsigned long)filter.version());
+  endpoint.path += query;
+
+  sendRevokedRequest(client, endpoint, apiKey);
+
+  unsigned long start = millis();
+  long contentLength;
+  int status = readHttpHead(client, contentLength, start);
+  if (status == 409) return REVOKED_SYNC_RESET;
+  if (status != 200) return status > 0 ? -status : status;
+
+  // The whole body must arrive before anything is applied
+  if (contentLength < 0) return HTTP_STREAM_ERROR_BAD_RESPONSE;
+  long remaining = contentLength;
+
+  // First line: generation G version V
+  char line[OID_MAX_ARCS * 11 + 2];
+  unsigned long generation, version;
+  if (readRevokedBodyLine(client, line, sizeof(line), remaining, start) < 0 ||
+      sscanf(line, "generation %lu version %lu", &generation, &version) != 2) {
+    return HTTP_STREAM_ERROR_BAD_RESPONSE;
+  }
+  if (generation != filter.generation() || version < filter.version()) return REVOKED_SYNC_RESET;
+
+  unsigned long count = version - filter.version();
+  if (count > REVOKED_DELTA_MAX) return REVOKED_SYNC_RESET;
+  if (count == 0) return 0;
+
+  uint64_t* hashes = (uint64_t*)malloc(count * sizeof(uint64_t));
+  if (!hashes) return REVOKED_SYNC_RESET;
+
+  unsigned long received = 0;
+  int result = 0;
+  while (remaining > 0) {
+    int len = readRevokedBodyLine(client, line, sizeof(line), remaining, start);
+    OIDValue oid;
+    if (len < 0 || received == count || !parseOIDValue(line, oid)) {
+      result = len < 0 ? len : HTTP_STREAM_ERROR_BAD_RESPONSE;
+      break;
+    }
+    hashes[received++] = revokedKeyHash(oid);
+  }
+
+  if (result == 0 && received == count) {
+    if (lock) lock->lock();
+    for (unsigned long i = 0; i < count; i++) filter.addHash(hashes[i]);
+    filter.setVersion(version);
+    if (lock) lock->unlock();
+    result = (int)count;
+  } else if (result == 0) {
+    result = HTTP_STREAM_ERROR_BAD_RESPONSE;
+  }
+  free(hashes);
+  return result;
+}
+
+/**
+ * Outcome of an upstream check of a filter hit
+ */
+enum RevokedConfirm {
+  REVOKED_CONFIRM_REVOKED,      // 200: upstream says revoked
+  REVOKED_CONFIRM_LIVE,         // 404: filter false positive
+  REVOKED_CONFIRM_UNAVAILABLE   // No answer, or any other status (401, 5xx, ...)
+};
+
+/**
+ * Ask upstream whether a filter hit is really revoked
+ * @param endpoint .../revoked/<oid>
+ * @param start millis() when the connection attempt began; the response
+ *        must arrive within REVOKED_CONFIRM_TIMEOUT_MS of it
+ * @param status Receives the HTTP status, or a negative HTTP_STREAM_ERROR_*
+ */
+template <typename TClient>
+RevokedConfirm confirmRevoked(TClient& client, const HttpEndpoint& endpoint, const char* apiKey,
+                              unsigned long start, int& status) {
+  unsigned long elapsed = millis() - start;
+  if (elapsed >= REVOKED_CONFIRM_TIMEOUT_MS) {
+    status = HTTP_STREAM_ERROR_TIMEOUT;
+    return REVOKED_CONFIRM_UNAVAILABLE;
+  }
+
+  sendRevokedRequest(client, endpoint, apiKey);
+
+  String body;
+  status = readHttpResponse(client, body, 0, REVOKED_CONFIRM_TIMEOUT_MS - elapsed);
+  if (status == 200) return REVOKED_CONFIRM_REVOKED;
+  if (status == 404) return REVOKED_CONFIRM_LIVE;
+  return REVOKED_CONFIRM_UNAVAILABLE;
+}
+
+#endif // REVOKED_FILTER_H
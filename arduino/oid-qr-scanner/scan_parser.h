@@ -0,0 +1,158 @@
+/**
+ * BrainSAIT OID Scan Payload Parser
+ *
+ * Classifies decoded QR payloads and extracts the OID scan data.
+ * Kept free of hardware dependencies so the host tools share it.
+ */
+
+#ifndef SCAN_PARSER_H
+#define SCAN_PARSER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "oid_utils.h"
+
+/**
+ * Scan data extracted from a QR payload
+ */
+struct OIDData {
+  String oid;
+  String name;
+  String description;
+  String nodeType;
+  String status;
+  String timestamp;
+  bool valid;
+};
+
+/**
+ * Payload formats recognised by the scanner
+ */
+enum ScanFormat {
+  SCAN_FORMAT_JSON_OID,     // BrainSAIT platform JSON with "oid"/"path"
+  SCAN_FORMAT_JSON_OTHER,   // Well-formed JSON without an OID
+  SCAN_FORMAT_RAW_OID,      // Bare OID string under the BrainSAIT root (arc-wise)
+  SCAN_FORMAT_UNKNOWN       // Anything else (including malformed JSON)
+};
+
+/**
+ * Where a scanned OID sits relative to the BrainSAIT arc
+ */
+enum ScanNamespace {
+  SCAN_NAMESPACE_BRAINSAIT,   // Under 1.3.6.1.4.1.61026
+  SCAN_NAMESPACE_FOREIGN,     // Well-formed OID elsewhere
+  SCAN_NAMESPACE_MALFORMED,   // Not a dotted OID
+  SCAN_NAMESPACE_NONE         // No OID in the payload
+};
+
+/**
+ * Get a short name for a payload format
+ * @param format Payload format
+ * @return Format name
+ */
+const char* scanFormatName(ScanFormat format) {
+  switch (format) {
+    case SCAN_FORMAT_JSON_OID:   return "json";
+    case SCAN_FORMAT_JSON_OTHER: return "json-other";
+    case SCAN_FORMAT_RAW_OID:    return "raw";
+    default:                     return "unknown";
+  }
+}
+
+/**
+ * Fill scan data from a BrainSAIT OID JSON document
+ *
+ * Expected BrainSAIT OID QR JSON format:
+ * {
+ *   "oid": "1.3.6.1.4.1.61026.3.2.1",
+ *   "name": "AI Normalizer Service",
+ *   "description": "Clinical coding and claim normalization service",
+ *   "nodeType": "leaf",
+ *   "status": "active",
+ *   "pen": 61026,
+ *   "provider": "BrainSAIT Enterprise",
+ *   "timestamp": "2025-01-30T10:00:00Z"
+ * }
+ *
+ * Foreign namespaces are still accepted; callers flag them.
+ */
+void parseOIDJson(JsonDocument& doc, OIDData& data) {
+  data.oid = doc["oid"] | doc["path"] | "";
+  data.name = doc["name"] | "Unknown";
+  data.description = doc["description"] | "";
+  data.nodeType = doc["nodeType"] | "unknown";
+  data.status = doc["status"] | "unknown";
+  data.timestamp = doc["timestamp"] | "";
+  data.valid = true;
+}
+
+/**
+ * Fill scan data from a raw OID string
+ */
+void parseRawOID(const String& oidString, OIDData& data) {
+  data.oid = oidString;
+  data.name = "Unknown (raw OID)";
+  data.description = "";
+  data.nodeType = "unknown";
+  data.status = "unknown";
+  data.timestamp = "";
+  data.valid = true;
+}
+
+/**
+ * Classify a QR payload and extract its scan data
+ * @param content Decoded QR payload
+ * @param data Receives the scan data; valid is false unless an OID was found
+ * @return Detected payload format
+ */
+ScanFormat parseScanPayload(const String& content, OIDData& data) {
+  data.valid = false;
+
+  // Try to parse as JSON (OID format from BrainSAIT platform)
+  StaticJsonDocument<1024> doc;
+  DeserializationError error = deserializeJson(doc, content);
+
+  if (!error) {
+    if (doc.containsKey("oid") || doc.containsKey("path")) {
+      parseOIDJson(doc, data);
+      return SCAN_FORMAT_JSON_OID;
+    }
+    return SCAN_FORMAT_JSON_OTHER;
+  }
+
+  // Not JSON - check for a raw OID under the BrainSAIT root, arc by arc
+  // as scanNamespace() checks JSON OIDs. Label generators often end the
+  // payload with a newline, so surrounding whitespace is dropped first.
+  String raw = content;
+  raw.trim();
+  if (isBrainSAITOID(raw)) {
+    parseRawOID(raw, data);
+    return SCAN_FORMAT_RAW_OID;
+  }
+
+  return SCAN_FORMAT_UNKNOWN;
+}
+
+/**
+ * Check a parsed scan's OID against the BrainSAIT namespace
+ *
+ * Compares arcs (parseOID), so "1.3.6.1.4.1.610260" is foreign even
+ * though it shares the root's text as a prefix.
+ */
+ScanNamespace scanNamespace(const OIDData& data) {
+  if (!data.valid || data.oid.length() == 0) return SCAN_NAMESPACE_NONE;
+  if (!validateOIDFormat(data.oid)) return SCAN_NAMESPACE_MALFORMED;
+  return parseOID(data.oid).isBrainSAIT ? SCAN_NAMESPACE_BRAINSAIT : SCAN_NAMESPACE_FOREIGN;
+}
+
+const char* scanNamespaceName(ScanNamespace ns) {
+  switch (ns) {
+    case SCAN_NAMESPACE_BRAINSAIT: return "brainsait";
+    case SCAN_NAMESPACE_FOREIGN:   return "foreign";
+    case SCAN_NAMESPACE_MALFORMED: return "malformed";
+    default:                       return "none";
+  }
+}
+
+#endif // SCAN_PARSER_H
@@ -0,0 +1,77 @@
+/**
+ * BrainSAIT OID Scanner - Non-blocking Serial Console
+ *
+ * Assembles command lines from a Stream one byte at a time so the scan
+ * loop never waits on partial input.
+ */
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+
+#ifndef CONSOLE_LINE_MAX
+#define CONSOLE_LINE_MAX    256     // Longest accepted command line
+#endif
+
+class SerialConsole {
+public:
+  explicit SerialConsole(Stream& stream) : _stream(stream) {}
+
+  /**
+   * Consume whatever input is already buffered
+   * @return true when a complete line is ready in line()
+   */
+  bool poll() {
+    if (_ready) {
+      // Previous line was handled; start a new one
+      _ready = false;
+      _length = 0;
+      _line[0] = '\0';
+    }
+
+    while (_stream.available() > 0) {
+      int c = _stream.read();
+      if (c < 0) break;
+
+      if (c == '\r' || c == '\n') {
+        if (_overflow) {
+          // Drop the oversized line entirely
+          _overflow = false;
+          _overflowCount++;
+          _length = 0;
+          continue;
+        }
+        if (_length == 0) continue;  // Blank line or second half of CRLF
+        _line[_length] = '\0';
+        _ready = true;
+        return true;
+      }
+
+      if (_overflow) continue;
+      if (_length >= CONSOLE_LINE_MAX - 1) {
+        _overflow = true;
+        continue;
+      }
+      _line[_length++] = (char)c;
+    }
+
+    return false;
+  }
+
+  /** Current complete line (valid after poll() returns true) */
+  const char* line() const { return _line; }
+
+  /** Number of lines dropped for exceeding CONSOLE_LINE_MAX */
+  uint32_t overflowCount() const { return _overflowCount; }
+
+private:
+  Stream& _stream;
+  char _line[CONSOLE_LINE_MAX] = {};
+  size_t _length = 0;
+  bool _ready = false;
+  bool _overflow = false;
+  uint32_t _overflowCount = 0;
+};
+
+#endif // SERIAL_CONSOLE_H